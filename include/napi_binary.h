@@ -0,0 +1,306 @@
+#ifndef OHOS_NAPI_BINARY_H
+#define OHOS_NAPI_BINARY_H
+
+#include "napi_framework.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+namespace OHOS {
+namespace napi {
+namespace binary {
+
+enum class Endian {
+    Little,
+    Big,
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    Native = Big,
+#else
+    Native = Little,
+#endif
+};
+
+/**
+ * Field 结构体成员在报文记录中的位置
+ * Member为成员指针，Offset为字段在记录内的字节偏移，E为字段的字节序。
+ * Wire为字段在报文中的类型，决定字段宽度（1/2/4/8字节），缺省与成员类型相同；
+ * 与成员类型不同时按static_cast转换，如报文中的uint16_t解码到int成员。
+ */
+template <auto Member, std::size_t Offset, Endian E = Endian::Little, typename Wire = void> struct Field;
+
+/**
+ * Bytes 原样拷贝的定长字节字段，成员须为平凡可拷贝的数组，如char[16]、std::array<std::uint8_t, 6>
+ */
+template <auto Member, std::size_t Offset> struct Bytes;
+
+/**
+ * Layout 紧凑报文记录的编译期布局描述
+ * Size为一条记录在报文中占用的字节数，也是数组中相邻记录的间距，各字段不得超出记录。
+ *   struct Header { std::uint16_t type; std::uint32_t length; float scale; };
+ *   using HeaderLayout = binary::Layout<Header, 10,
+ *                                       binary::Field<&Header::type, 0, binary::Endian::Big>,
+ *                                       binary::Field<&Header::length, 2, binary::Endian::Big>,
+ *                                       binary::Field<&Header::scale, 6>>;
+ *   Header header = binary::decode<HeaderLayout>(cbInfo[0].as<DataView>());
+ * 字段偏移与字节序都是编译期常量，解码一条记录只是若干次定长读取与字节交换，
+ * 整个缓冲区只在开始时调用一次NAPI获取地址。
+ */
+template <typename T, std::size_t Size, typename... Fields> struct Layout {
+    using Type = T;
+    static constexpr std::size_t kSize = Size;
+
+    static_assert((std::is_same<typename Fields::Class, T>::value && ...), "Field does not belong to layout type");
+    static_assert(((Fields::kOffset + Fields::kWidth <= Size) && ...), "Field exceeds record size");
+
+    /// src指向一条记录的首字节，调用方保证至少有kSize字节
+    static void Decode(const std::uint8_t *src, T &out) { (Fields::Decode(src, out), ...); }
+    /// dst指向一条记录的首字节，不属于任何字段的字节保持不变
+    static void Encode(const T &in, std::uint8_t *dst) { (Fields::Encode(in, dst), ...); }
+};
+
+/// 从view的offset处解码一条记录，越界时抛出异常
+template <typename L> typename L::Type decode(const DataView &view, std::size_t offset = 0);
+/// 从offset处依次解码count条记录到out[0, count)
+template <typename L>
+void decode(const DataView &view, std::size_t offset, typename L::Type *out, std::size_t count);
+template <typename L>
+std::vector<typename L::Type> decodeArray(const DataView &view, std::size_t offset, std::size_t count);
+
+/// 把一条记录编码到view的offset处
+template <typename L> void encode(const DataView &view, std::size_t offset, const typename L::Type &value);
+/// 把in[0, count)依次编码到view的offset处
+template <typename L>
+void encode(const DataView &view, std::size_t offset, const typename L::Type *in, std::size_t count);
+
+/// 从offset处读取count个按endian存放的T，字节序与本机不同时批量交换（SSE2/NEON）
+template <typename T> void read(const DataView &view, std::size_t offset, T *out, std::size_t count, Endian endian);
+template <typename T>
+std::vector<T> readArray(const DataView &view, std::size_t offset, std::size_t count, Endian endian);
+/// 把in[0, count)按endian写入offset处
+template <typename T>
+void write(const DataView &view, std::size_t offset, const T *in, std::size_t count, Endian endian);
+
+/// 对内存中的数组原地交换字节序
+template <typename T> void byteSwap(T *data, std::size_t count);
+
+/* --------------------------------- details -------------------------------- */
+
+namespace details {
+
+template <typename M> struct MemberPointer;
+template <typename C, typename V> struct MemberPointer<V C::*> {
+    using Class = C;
+    using Type = V;
+};
+
+template <std::size_t Width> struct UintOf;
+template <> struct UintOf<1> {
+    using type = std::uint8_t;
+};
+template <> struct UintOf<2> {
+    using type = std::uint16_t;
+};
+template <> struct UintOf<4> {
+    using type = std::uint32_t;
+};
+template <> struct UintOf<8> {
+    using type = std::uint64_t;
+};
+
+template <typename U> inline U ByteSwap(U value) {
+    if constexpr (sizeof(U) == 1) {
+        return value;
+    } else if constexpr (sizeof(U) == 2) {
+        return __builtin_bswap16(value);
+    } else if constexpr (sizeof(U) == 4) {
+        return __builtin_bswap32(value);
+    } else {
+        return __builtin_bswap64(value);
+    }
+}
+
+template <typename Wire, Endian E> inline Wire Load(const std::uint8_t *src) {
+    typename UintOf<sizeof(Wire)>::type bits;
+    std::memcpy(&bits, src, sizeof(bits));
+    if constexpr (E != Endian::Native) {
+        bits = ByteSwap(bits);
+    }
+    Wire result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+template <typename Wire, Endian E> inline void Store(std::uint8_t *dst, Wire value) {
+    typename UintOf<sizeof(Wire)>::type bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    if constexpr (E != Endian::Native) {
+        bits = ByteSwap(bits);
+    }
+    std::memcpy(dst, &bits, sizeof(bits));
+}
+
+// 把count个宽度为Width的元素从src交换字节序后写到dst，src与dst可以相同
+template <std::size_t Width> inline void ByteSwapCopy(const std::uint8_t *src, std::uint8_t *dst, std::size_t count) {
+    const std::size_t bytes = count * Width;
+    std::size_t i = 0;
+    if constexpr (Width > 1) {
+#if defined(__SSE2__)
+        for (; i + 16 <= bytes; i += 16) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+            // 先交换每个16位内的两个字节，再按元素宽度倒序排列16位单元
+            v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+            if constexpr (Width == 4) {
+                v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+            } else if constexpr (Width == 8) {
+                v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, _MM_SHUFFLE(0, 1, 2, 3)), _MM_SHUFFLE(0, 1, 2, 3));
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), v);
+        }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+        for (; i + 16 <= bytes; i += 16) {
+            uint8x16_t v = vld1q_u8(src + i);
+            if constexpr (Width == 2) {
+                v = vrev16q_u8(v);
+            } else if constexpr (Width == 4) {
+                v = vrev32q_u8(v);
+            } else {
+                v = vrev64q_u8(v);
+            }
+            vst1q_u8(dst + i, v);
+        }
+#endif
+    }
+    for (; i < bytes; i += Width) {
+        typename UintOf<Width>::type bits;
+        std::memcpy(&bits, src + i, Width);
+        bits = ByteSwap(bits);
+        std::memcpy(dst + i, &bits, Width);
+    }
+}
+
+// 一次napi_get_dataview_info取得地址与长度，并检查[offset, offset + count * stride)不越界
+inline std::uint8_t *ViewRange(const DataView &view, std::size_t offset, std::size_t count, std::size_t stride) {
+    std::size_t length;
+    void *data;
+    NAPI_CHECK_STATUS(view.env(), napi_get_dataview_info(view.env(), view, &length, &data, nullptr, nullptr),
+                      "napi_get_dataview_info failed");
+    if (offset > length || (stride != 0 && count > (length - offset) / stride)) {
+        throw std::out_of_range("DataView access out of range");
+    }
+    return static_cast<std::uint8_t *>(data) + offset;
+}
+
+} // namespace details
+
+template <auto Member, std::size_t Offset, Endian E, typename Wire> struct Field {
+    using Class = typename details::MemberPointer<decltype(Member)>::Class;
+    using Type = typename details::MemberPointer<decltype(Member)>::Type;
+    using WireType = std::conditional_t<std::is_void<Wire>::value, Type, Wire>;
+
+    static constexpr std::size_t kOffset = Offset;
+    static constexpr std::size_t kWidth = sizeof(WireType);
+
+    static_assert(std::is_arithmetic<WireType>::value || std::is_enum<WireType>::value,
+                  "Field wire type must be arithmetic or enum, use Bytes for raw data");
+    static_assert(kWidth == 1 || kWidth == 2 || kWidth == 4 || kWidth == 8, "Unsupported field width");
+
+    static void Decode(const std::uint8_t *src, Class &out) {
+        out.*Member = static_cast<Type>(details::Load<WireType, E>(src + Offset));
+    }
+    static void Encode(const Class &in, std::uint8_t *dst) {
+        details::Store<WireType, E>(dst + Offset, static_cast<WireType>(in.*Member));
+    }
+};
+
+template <auto Member, std::size_t Offset> struct Bytes {
+    using Class = typename details::MemberPointer<decltype(Member)>::Class;
+    using Type = typename details::MemberPointer<decltype(Member)>::Type;
+
+    static constexpr std::size_t kOffset = Offset;
+    static constexpr std::size_t kWidth = sizeof(Type);
+
+    static_assert(std::is_trivially_copyable<Type>::value, "Bytes field must be trivially copyable");
+
+    static void Decode(const std::uint8_t *src, Class &out) { std::memcpy(&(out.*Member), src + Offset, kWidth); }
+    static void Encode(const Class &in, std::uint8_t *dst) { std::memcpy(dst + Offset, &(in.*Member), kWidth); }
+};
+
+template <typename L> inline typename L::Type decode(const DataView &view, std::size_t offset) {
+    typename L::Type result{};
+    L::Decode(details::ViewRange(view, offset, 1, L::kSize), result);
+    return result;
+}
+
+template <typename L>
+inline void decode(const DataView &view, std::size_t offset, typename L::Type *out, std::size_t count) {
+    const std::uint8_t *src = details::ViewRange(view, offset, count, L::kSize);
+    for (std::size_t i = 0; i < count; ++i, src += L::kSize) {
+        L::Decode(src, out[i]);
+    }
+}
+
+template <typename L>
+inline std::vector<typename L::Type> decodeArray(const DataView &view, std::size_t offset, std::size_t count) {
+    const std::uint8_t *src = details::ViewRange(view, offset, count, L::kSize);
+    std::vector<typename L::Type> result(count);
+    for (std::size_t i = 0; i < count; ++i, src += L::kSize) {
+        L::Decode(src, result[i]);
+    }
+    return result;
+}
+
+template <typename L> inline void encode(const DataView &view, std::size_t offset, const typename L::Type &value) {
+    L::Encode(value, details::ViewRange(view, offset, 1, L::kSize));
+}
+
+template <typename L>
+inline void encode(const DataView &view, std::size_t offset, const typename L::Type *in, std::size_t count) {
+    std::uint8_t *dst = details::ViewRange(view, offset, count, L::kSize);
+    for (std::size_t i = 0; i < count; ++i, dst += L::kSize) {
+        L::Encode(in[i], dst);
+    }
+}
+
+template <typename T>
+inline void read(const DataView &view, std::size_t offset, T *out, std::size_t count, Endian endian) {
+    static_assert(std::is_arithmetic<T>::value, "read requires an arithmetic element type");
+    const std::uint8_t *src = details::ViewRange(view, offset, count, sizeof(T));
+    if (endian == Endian::Native || sizeof(T) == 1) {
+        std::memcpy(out, src, count * sizeof(T));
+    } else {
+        details::ByteSwapCopy<sizeof(T)>(src, reinterpret_cast<std::uint8_t *>(out), count);
+    }
+}
+
+template <typename T>
+inline std::vector<T> readArray(const DataView &view, std::size_t offset, std::size_t count, Endian endian) {
+    std::vector<T> result(count);
+    read(view, offset, result.data(), count, endian);
+    return result;
+}
+
+template <typename T>
+inline void write(const DataView &view, std::size_t offset, const T *in, std::size_t count, Endian endian) {
+    static_assert(std::is_arithmetic<T>::value, "write requires an arithmetic element type");
+    std::uint8_t *dst = details::ViewRange(view, offset, count, sizeof(T));
+    if (endian == Endian::Native || sizeof(T) == 1) {
+        std::memmove(dst, in, count * sizeof(T));
+    } else {
+        details::ByteSwapCopy<sizeof(T)>(reinterpret_cast<const std::uint8_t *>(in), dst, count);
+    }
+}
+
+template <typename T> inline void byteSwap(T *data, std::size_t count) {
+    static_assert(std::is_arithmetic<T>::value, "byteSwap requires an arithmetic element type");
+    auto *bytes = reinterpret_cast<std::uint8_t *>(data);
+    details::ByteSwapCopy<sizeof(T)>(bytes, bytes, count);
+}
+
+} // namespace binary
+} // namespace napi
+} // namespace OHOS
+
+#endif // OHOS_NAPI_BINARY_H
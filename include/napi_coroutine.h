@@ -0,0 +1,318 @@
+#ifndef OHOS_NAPI_COROUTINE_H
+#define OHOS_NAPI_COROUTINE_H
+
+#include "napi_framework.h"
+
+// C++20协程支持：导出函数可以写成返回napi::Task<T>的协程，JS侧拿到的是一个Promise。
+// 需要以C++20及以上标准编译，否则本文件为空。
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+
+#include <chrono>
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <type_traits>
+
+namespace OHOS {
+namespace napi {
+
+namespace coro {
+// co_await一个被reject的Promise时抛出，reason()仅在抛出后、下一次co_await之前有效
+class PromiseRejected : public std::runtime_error {
+public:
+    PromiseRejected(napi_env env, napi_value reason)
+        : std::runtime_error("Promise rejected"), env_(env), reason_(reason) {}
+
+    Value reason() const { return Value(env_, reason_); }
+
+private:
+    napi_env env_;
+    napi_value reason_;
+};
+} // namespace coro
+
+namespace coro {
+namespace details {
+// Task<T>::promise_type的公共部分
+class PromiseBase {
+public:
+    template <typename... Args> PromiseBase(napi_env env, Args &...) : env_(env) {}
+
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+
+    void unhandled_exception() noexcept {
+        napi_value reason = nullptr;
+        try {
+            throw;
+        } catch (const PromiseRejected &e) {
+            reason = e.reason();
+        } catch (const std::exception &e) {
+            napi_value message;
+            if (napi_create_string_utf8(env_, e.what(), NAPI_AUTO_LENGTH, &message) == napi_ok) {
+                napi_create_error(env_, nullptr, message, &reason);
+            }
+        } catch (...) {
+            napi_value message;
+            if (napi_create_string_utf8(env_, "unknown native exception", NAPI_AUTO_LENGTH, &message) == napi_ok) {
+                napi_create_error(env_, nullptr, message, &reason);
+            }
+        }
+        if (reason == nullptr) {
+            napi_get_undefined(env_, &reason);
+        }
+        napi_reject_deferred(env_, deferred_, reason);
+    }
+
+protected:
+    napi_value createPromise() {
+        napi_value promise;
+        NAPI_CHECK_STATUS(env_, napi_create_promise(env_, &deferred_, &promise), "napi_create_promise failed");
+        return promise;
+    }
+
+    napi_env env_;
+    napi_deferred deferred_ = nullptr;
+};
+
+template <typename T> class TaskPromise : public PromiseBase {
+public:
+    using PromiseBase::PromiseBase;
+
+    void return_value(const T &value) { napi_resolve_deferred(env_, deferred_, Value::From(env_, value)); }
+};
+
+template <> class TaskPromise<void> : public PromiseBase {
+public:
+    using PromiseBase::PromiseBase;
+
+    void return_void() {
+        napi_value undefined;
+        napi_get_undefined(env_, &undefined);
+        napi_resolve_deferred(env_, deferred_, undefined);
+    }
+};
+} // namespace details
+} // namespace coro
+
+/**
+ * Task 协程导出函数的返回类型，JS侧看到的是一个Promise
+ * 协程的第一个参数必须是Env或napi_env，用于创建Promise。协程会立即开始执行，
+ * co_return的值（T类型）通过Value::From转换后resolve该Promise，Task<void>的协程以co_return;结束并resolve为undefined；
+ * 未捕获的异常会reject该Promise。
+ * 每次co_await之后都在JS线程上恢复执行。
+ * @note 每次恢复执行都处于新的handle scope中，co_await之前获取的napi_value（包括CallbackInfo中的参数）
+ * 在co_await之后都已失效，需要跨co_await持有的JS值请使用tools::Reference。
+ * @note 协程帧比单次调用活得久，协程体内不使用CallArena：ArenaVector等退化为堆分配，
+ * 转换为std::string_view会抛出异常，请使用std::string。
+ */
+template <typename T = Value> class Task {
+public:
+    struct promise_type : coro::details::TaskPromise<T> {
+        using coro::details::TaskPromise<T>::TaskPromise;
+
+        Task get_return_object() { return Task(this->env_, this->createPromise()); }
+    };
+
+    napi_env env() const { return env_; }
+    /// 协程对应的JS Promise，只在创建协程的handle scope内有效
+    Value promise() const { return Value(env_, promise_); }
+    operator napi_value() const { return promise_; }
+
+private:
+    Task(napi_env env, napi_value promise) : env_(env), promise_(promise) {}
+
+    napi_env env_;
+    napi_value promise_;
+};
+
+namespace coro {
+
+namespace details {
+template <typename Fn> class PoolAwaiter {
+    using R = std::invoke_result_t<Fn &>;
+
+public:
+    PoolAwaiter(napi_env env, Fn fn) : env_(env), fn_(std::move(fn)) {}
+
+    bool await_ready() const noexcept { return false; }
+
+    void await_suspend(std::coroutine_handle<> handle) {
+        handle_ = handle;
+        napi_value resourceName;
+        NAPI_CHECK_STATUS(env_, napi_create_string_utf8(env_, "napi_coroutine", NAPI_AUTO_LENGTH, &resourceName),
+                          "napi_create_string_utf8 failed");
+        NAPI_CHECK_STATUS(env_, napi_create_async_work(env_, nullptr, resourceName, Execute, Complete, this, &work_),
+                          "napi_create_async_work failed");
+        napi_status status = napi_queue_async_work(env_, work_);
+        if (status != napi_ok) {
+            napi_delete_async_work(env_, work_);
+            NAPI_CHECK_STATUS(env_, status, "napi_queue_async_work failed");
+        }
+    }
+
+    R await_resume() {
+        if (error_) {
+            std::rethrow_exception(error_);
+        }
+        if constexpr (!std::is_void<R>::value) {
+            return std::move(*result_);
+        }
+    }
+
+private:
+    // 在线程池中执行
+    static void Execute(napi_env, void *data) {
+        auto *self = static_cast<PoolAwaiter *>(data);
+        try {
+            if constexpr (std::is_void<R>::value) {
+                self->fn_();
+            } else {
+                self->result_.emplace(self->fn_());
+            }
+        } catch (...) {
+            self->error_ = std::current_exception();
+        }
+    }
+
+    // 在JS线程中执行，直接在此恢复协程，不再额外切换线程
+    static void Complete(napi_env env, napi_status status, void *data) {
+        auto *self = static_cast<PoolAwaiter *>(data);
+        napi_delete_async_work(env, self->work_);
+        if (status == napi_cancelled && !self->error_) {
+            self->error_ = std::make_exception_ptr(std::runtime_error("async work cancelled"));
+        }
+        tools::CallArena::Pause arenaPause;
+        self->handle_.resume();
+    }
+
+    using Result = typename std::conditional<std::is_void<R>::value, char, R>::type;
+
+    napi_env env_;
+    Fn fn_;
+    napi_async_work work_ = nullptr;
+    std::coroutine_handle<> handle_;
+    std::optional<Result> result_;
+    std::exception_ptr error_;
+};
+
+// 通过一次性的JS回调函数恢复协程，用于Promise的then和setTimeout
+class CallbackAwaiter {
+public:
+    explicit CallbackAwaiter(napi_env env) : env_(env) {}
+
+protected:
+    static napi_value OnFulfilled(napi_env env, napi_callback_info info) { return Resume(env, info, false); }
+    static napi_value OnRejected(napi_env env, napi_callback_info info) { return Resume(env, info, true); }
+
+    static napi_value Resume(napi_env env, napi_callback_info info, bool rejected) {
+        napi::details::HotValueScope hotValueScope;
+        std::size_t argc = 1;
+        napi_value argv[1] = {nullptr};
+        void *data;
+        napi_get_cb_info(env, info, &argc, argv, nullptr, &data);
+        auto *self = static_cast<CallbackAwaiter *>(data);
+        self->result_ = argc > 0 ? argv[0] : nullptr;
+        self->rejected_ = rejected;
+        tools::CallArena::Pause arenaPause;
+        self->handle_.resume();
+        napi_value undefined;
+        napi_get_undefined(env, &undefined);
+        return undefined;
+    }
+
+    napi_env env_;
+    std::coroutine_handle<> handle_;
+    napi_value result_ = nullptr;
+    bool rejected_ = false;
+};
+
+class PromiseAwaiter : public CallbackAwaiter {
+public:
+    explicit PromiseAwaiter(Value value) : CallbackAwaiter(value.env()), value_(value) {}
+
+    bool await_ready() {
+        bool isPromise;
+        NAPI_CHECK_STATUS(env_, napi_is_promise(env_, value_, &isPromise), "napi_is_promise failed");
+        if (!isPromise) {
+            // 与JS的await语义一致，非Promise的值直接作为结果
+            result_ = value_;
+        }
+        return !isPromise;
+    }
+
+    void await_suspend(std::coroutine_handle<> handle) {
+        handle_ = handle;
+        Object promise(env_, value_);
+        Function then = promise.get("then").as<Function>();
+        Function onFulfilled = Function::Create(env_, "onFulfilled", OnFulfilled, this);
+        Function onRejected = Function::Create(env_, "onRejected", OnRejected, this);
+        then.call(promise, {onFulfilled, onRejected});
+    }
+
+    Value await_resume() {
+        if (rejected_) {
+            throw PromiseRejected(env_, result_);
+        }
+        return Value(env_, result_);
+    }
+
+private:
+    napi_value value_;
+};
+
+class TimerAwaiter : public CallbackAwaiter {
+public:
+    TimerAwaiter(napi_env env, std::chrono::milliseconds delay) : CallbackAwaiter(env), delay_(delay) {}
+
+    bool await_ready() const noexcept { return false; }
+
+    void await_suspend(std::coroutine_handle<> handle) {
+        handle_ = handle;
+        Env env(env_);
+        Function setTimeout = env.global().as<Object>().get("setTimeout").as<Function>();
+        Function onTimeout = Function::Create(env_, "onTimeout", OnFulfilled, this);
+        setTimeout.call(env.undefined(), {onTimeout, Number::Create(env_, static_cast<double>(delay_.count()))});
+    }
+
+    void await_resume() const noexcept {}
+
+private:
+    std::chrono::milliseconds delay_;
+};
+} // namespace details
+
+/// 在NAPI线程池中执行fn，完成后回到JS线程恢复协程，co_await的结果为fn的返回值。
+/// fn中不能访问任何JS值。
+template <typename Fn> details::PoolAwaiter<std::decay_t<Fn>> runInPool(napi_env env, Fn &&fn) {
+    return details::PoolAwaiter<std::decay_t<Fn>>(env, std::forward<Fn>(fn));
+}
+
+/// 等待一个JS Promise，结果为其resolve的值；被reject时抛出PromiseRejected。
+inline details::PromiseAwaiter awaitPromise(Value promise) { return details::PromiseAwaiter(promise); }
+
+/// 通过JS的setTimeout等待一段时间，不占用任何线程
+inline details::TimerAwaiter sleepFor(napi_env env, std::chrono::milliseconds delay) {
+    return details::TimerAwaiter(env, delay);
+}
+
+} // namespace coro
+} // namespace napi
+} // namespace OHOS
+
+// 定义一个协程导出函数，body中使用co_await/co_return，JS侧调用得到Promise
+// @note cbInfo只在第一次co_await之前有效；协程帧比本次调用活得久，因此这里暂停而不是打开CallArena
+#define NAPI_CORO_FUNC(name, argc, ...)                                                                                \
+    static OHOS::napi::Task<> napi_coro__##name(OHOS::napi::Env env, const OHOS::napi::CallbackInfo &cbInfo)           \
+        __VA_ARGS__                                                                                                    \
+    static napi_value napi__##name(napi_env environment, napi_callback_info information) {                             \
+        OHOS::napi::tools::CallArena::Pause arenaPause;                                                                \
+        OHOS::napi::details::HotValueScope hotValueScope;                                                              \
+        OHOS::napi::Env env(environment);                                                                              \
+        OHOS::napi::CallbackInfo cbInfo(environment, information, argc);                                               \
+        return napi_coro__##name(env, cbInfo);                                                                         \
+    }
+
+#endif // __cpp_impl_coroutine
+
+#endif // OHOS_NAPI_COROUTINE_H
@@ -0,0 +1,354 @@
+#ifndef OHOS_NAPI_EVENT_H
+#define OHOS_NAPI_EVENT_H
+
+#include "napi_task.h"
+
+namespace OHOS {
+namespace napi {
+namespace tools {
+
+/**
+ * EventBus 按主题分发事件的事件总线
+ * 每个主题可以有多个JS监听器；Native代码从任意线程publish，事件先在主题下排队，
+ * 由TaskPoster在JS线程上批量投递：每个主题一次只调用一次JS分发函数，由它在JS侧把本批全部事件依次交给全部监听器，
+ * 每个事件的跨边界调用从O(监听器数)降为O(1)。
+ * 分发函数通过Function构造函数在JS侧生成；运行环境禁止动态生成代码时退回到Native侧逐个调用监听器。
+ * 某个监听器抛出的异常不影响其他监听器，某个主题分发失败（含事件转换时的C++异常）也不影响其他主题，
+ * 本批分发结束后重新抛出第一个异常。
+ * 订阅与取消订阅在下一批分发时生效，正在进行的分发使用旧的监听器列表。
+ *   auto bus = tools::EventBus::Get(env);       // JS线程
+ *   exports.set("events", bus->binding());       // JS: events.subscribe("progress", fn) / events.unsubscribe(id)
+ *   bus->publish("progress", 42);                // 任意线程
+ */
+class EventBus : public std::enable_shared_from_this<EventBus> {
+    struct Private {};
+
+public:
+    using Subscription = std::uint64_t;
+    /// 在JS线程上把事件转换为JS值
+    using Payload = std::function<napi_value(napi_env)>;
+
+    /// env的事件总线，首次调用时创建，须在JS线程上调用；返回的指针可以交给任意线程持有
+    static std::shared_ptr<EventBus> Get(napi_env env);
+
+    /// 订阅topic，须在JS线程上调用
+    Subscription subscribe(std::string_view topic, const Function &listener);
+    /// 取消订阅，须在JS线程上调用。返回订阅是否存在
+    bool unsubscribe(Subscription subscription);
+    /// 含subscribe(topic, listener)与unsubscribe(subscription)两个方法的JS对象
+    Object binding();
+
+    /// 发布事件，任意线程可调用，value在JS线程上通过Converter转换。
+    /// 主题没有监听器或env已销毁时丢弃事件并返回false
+    template <typename T> bool publish(std::string_view topic, T value);
+    /// 发布不带数据的事件，监听器收到undefined
+    bool publish(std::string_view topic);
+    bool publishPayload(std::string_view topic, Payload payload);
+
+    /// 已发布尚未投递的事件数
+    std::size_t pending() const;
+
+    EventBus(Private, napi_env env, std::shared_ptr<TaskPoster> poster) : env_(env), poster_(std::move(poster)) {}
+
+private:
+    struct Topic {
+        std::vector<Payload> events;
+        // 以下只在JS线程上访问。监听器数组在订阅变化时整体替换（写时复制），分发中持有的旧数组不受影响
+        UniqueReference<Array> listeners;
+        std::vector<Subscription> subscriptions; // 与listeners一一对应
+        std::size_t listenerCount = 0;
+    };
+    struct Batch {
+        std::string topic;
+        std::vector<Payload> events;
+    };
+    struct Holder {
+        std::shared_ptr<EventBus> bus;
+    };
+
+    void flush(napi_env env);
+    void dispatch(napi_env env, napi_value listeners, const Batch &batch);
+    // 返回空表示运行环境不支持，退回到Native分发
+    napi_value dispatcher(napi_env env);
+    // 以subscriptions为准重建topic的监听器数组，skip为要去掉的下标
+    void rebuild(Topic &topic, napi_value oldListeners, napi_value added, std::size_t skip);
+
+    napi_env env_;
+    std::shared_ptr<TaskPoster> poster_;
+    mutable std::mutex mtx_;
+    std::unordered_map<std::string, Topic> topics_;
+    std::vector<std::string> dirty_; // 有待投递事件的主题，按首次发布的顺序
+    std::size_t pending_ = 0;
+    bool flushQueued_ = false;
+
+    // 以下只在JS线程上访问
+    std::unordered_map<Subscription, std::string> subscriptions_;
+    Subscription nextSubscription_ = 1;
+    UniqueReference<Function> dispatcher_;
+    bool nativeDispatch_ = false;
+};
+
+/* --------------------------------- details -------------------------------- */
+
+inline std::shared_ptr<EventBus> EventBus::Get(napi_env env) {
+    Holder &holder = napi::details::EnvLocal<Holder>::Get(env);
+    if (holder.bus == nullptr) {
+        holder.bus = std::make_shared<EventBus>(Private{}, env, TaskPoster::Get(env));
+    }
+    return holder.bus;
+}
+
+inline EventBus::Subscription EventBus::subscribe(std::string_view topic, const Function &listener) {
+    std::lock_guard<std::mutex> lck(mtx_);
+    Topic &entry = topics_[std::string(topic)];
+    napi_value oldListeners = entry.listeners.empty() ? nullptr : static_cast<napi_value>(entry.listeners.value());
+    Subscription subscription = nextSubscription_;
+    rebuild(entry, oldListeners, listener, entry.subscriptions.size());
+    entry.subscriptions.push_back(subscription);
+    entry.listenerCount = entry.subscriptions.size();
+    subscriptions_.emplace(subscription, std::string(topic));
+    ++nextSubscription_;
+    return subscription;
+}
+
+inline bool EventBus::unsubscribe(Subscription subscription) {
+    auto it = subscriptions_.find(subscription);
+    if (it == subscriptions_.end()) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lck(mtx_);
+    Topic &entry = topics_[it->second];
+    auto pos = std::find(entry.subscriptions.begin(), entry.subscriptions.end(), subscription);
+    std::size_t index = static_cast<std::size_t>(pos - entry.subscriptions.begin());
+    rebuild(entry, entry.listeners.value(), nullptr, index);
+    entry.subscriptions.erase(pos);
+    entry.listenerCount = entry.subscriptions.size();
+    if (entry.listenerCount == 0 && entry.events.empty()) {
+        topics_.erase(it->second);
+    }
+    subscriptions_.erase(it);
+    return true;
+}
+
+inline void EventBus::rebuild(Topic &topic, napi_value oldListeners, napi_value added, std::size_t skip) {
+    std::size_t count = topic.subscriptions.size();
+    std::size_t length = added != nullptr ? count + 1 : count - 1;
+    Array listeners = Array::Create(env_, length);
+    std::uint32_t j = 0;
+    for (std::uint32_t i = 0; i < count; ++i) {
+        if (i == skip) {
+            continue;
+        }
+        napi_value listener;
+        NAPI_CHECK_STATUS(env_, napi_get_element(env_, oldListeners, i, &listener), "napi_get_element failed");
+        NAPI_CHECK_STATUS(env_, napi_set_element(env_, listeners, j++, listener), "napi_set_element failed");
+    }
+    if (added != nullptr) {
+        NAPI_CHECK_STATUS(env_, napi_set_element(env_, listeners, j, added), "napi_set_element failed");
+    }
+    if (topic.listeners.empty()) {
+        topic.listeners = UniqueReference<Array>::Create(listeners, 1);
+    } else {
+        topic.listeners.reset(listeners, 1);
+    }
+}
+
+inline Object EventBus::binding() {
+    Object result = Object::Create(env_);
+    std::weak_ptr<EventBus> weak = weak_from_this();
+    result.set("subscribe", Function::Create(env_, "subscribe", [weak](const CallbackInfo &info) -> double {
+                   auto bus = weak.lock();
+                   if (bus == nullptr) {
+                       throw std::runtime_error("Event bus has been closed");
+                   }
+                   if (info[1].type() != napi_function) {
+                       throw std::invalid_argument("Listener must be a function");
+                   }
+                   return static_cast<double>(bus->subscribe(info[0].as<std::string>(), Function(info.env(), info[1])));
+               }));
+    result.set("unsubscribe", Function::Create(env_, "unsubscribe", [weak](const CallbackInfo &info) {
+                   auto bus = weak.lock();
+                   return bus != nullptr && bus->unsubscribe(static_cast<Subscription>(info[0].as<double>()));
+               }));
+    return result;
+}
+
+template <typename T> inline bool EventBus::publish(std::string_view topic, T value) {
+    return publishPayload(topic, [value = std::move(value)](napi_env env) { return Converter<T>::ToJS(env, value); });
+}
+
+inline bool EventBus::publish(std::string_view topic) {
+    return publishPayload(topic, [](napi_env env) -> napi_value { return Env(env).undefined(); });
+}
+
+inline bool EventBus::publishPayload(std::string_view topic, Payload payload) {
+    std::lock_guard<std::mutex> lck(mtx_);
+    auto it = topics_.find(std::string(topic));
+    if (it == topics_.end() || it->second.listenerCount == 0) {
+        return false;
+    }
+    if (it->second.events.empty()) {
+        dirty_.push_back(it->first);
+    }
+    it->second.events.push_back(std::move(payload));
+    ++pending_;
+    if (flushQueued_) {
+        return true;
+    }
+    // 一次投递负责此后到执行前发布的全部事件
+    bool posted = poster_->post([self = shared_from_this()](napi_env env) { self->flush(env); });
+    if (!posted) {
+        it->second.events.pop_back();
+        --pending_;
+        if (it->second.events.empty()) {
+            dirty_.pop_back();
+        }
+        return false;
+    }
+    flushQueued_ = true;
+    return true;
+}
+
+inline std::size_t EventBus::pending() const {
+    std::lock_guard<std::mutex> lck(mtx_);
+    return pending_;
+}
+
+inline void EventBus::flush(napi_env env) {
+    std::vector<Batch> batches;
+    std::vector<napi_value> listeners;
+    {
+        std::lock_guard<std::mutex> lck(mtx_);
+        flushQueued_ = false;
+        batches.reserve(dirty_.size());
+        listeners.reserve(dirty_.size());
+        for (std::string &name : dirty_) {
+            Topic &topic = topics_[name];
+            pending_ -= topic.events.size();
+            if (topic.listenerCount == 0) {
+                topics_.erase(name); // 发布之后监听器已全部取消
+                continue;
+            }
+            listeners.push_back(topic.listeners.value());
+            batches.push_back(Batch{std::move(name), std::move(topic.events)});
+            topic.events.clear();
+        }
+        dirty_.clear();
+    }
+    napi_value firstError = nullptr;
+    for (std::size_t i = 0; i < batches.size(); ++i) {
+        const char *message = nullptr;
+        std::string what;
+        try {
+            dispatch(env, listeners[i], batches[i]);
+        } catch (const std::exception &e) {
+            what = e.what();
+            message = what.c_str();
+        } catch (...) {
+            message = "unknown native exception";
+        }
+        // 记录第一个错误后继续分发其余主题：JS异常优先，否则把C++异常转换为Error
+        napi_value error = nullptr;
+        bool pendingException = false;
+        napi_is_exception_pending(env, &pendingException);
+        if (pendingException) {
+            napi_get_and_clear_last_exception(env, &error);
+        } else if (message != nullptr) {
+            napi_value text;
+            if (napi_create_string_utf8(env, message, NAPI_AUTO_LENGTH, &text) != napi_ok ||
+                napi_create_error(env, nullptr, text, &error) != napi_ok) {
+                error = nullptr;
+            }
+        }
+        firstError = firstError != nullptr ? firstError : error;
+    }
+    if (firstError != nullptr) {
+        napi_throw(env, firstError);
+    }
+}
+
+inline void EventBus::dispatch(napi_env env, napi_value listeners, const Batch &batch) {
+    HandleScope scope(env);
+    napi_value events;
+    NAPI_CHECK_STATUS(env, napi_create_array_with_length(env, batch.events.size(), &events), "Create array failed");
+    for (std::size_t i = 0; i < batch.events.size(); ++i) {
+        NAPI_CHECK_STATUS(env, napi_set_element(env, events, static_cast<std::uint32_t>(i), batch.events[i](env)),
+                          "napi_set_element failed");
+    }
+    napi_value undefined = Env(env).undefined();
+    napi_value fn = dispatcher(env);
+    if (fn != nullptr) {
+        napi_value argv[] = {listeners, events};
+        napi_value result;
+        napi_call_function(env, undefined, fn, 2, argv, &result); // 异常留给flush处理
+        return;
+    }
+    // Native分发：与JS分发函数的语义一致
+    std::uint32_t listenerCount;
+    NAPI_CHECK_STATUS(env, napi_get_array_length(env, listeners, &listenerCount), "napi_get_array_length failed");
+    napi_value firstError = nullptr;
+    for (std::uint32_t i = 0; i < batch.events.size(); ++i) {
+        napi_value event;
+        NAPI_CHECK_STATUS(env, napi_get_element(env, events, i, &event), "napi_get_element failed");
+        for (std::uint32_t j = 0; j < listenerCount; ++j) {
+            napi_value listener;
+            napi_value result;
+            NAPI_CHECK_STATUS(env, napi_get_element(env, listeners, j, &listener), "napi_get_element failed");
+            if (napi_call_function(env, undefined, listener, 1, &event, &result) == napi_pending_exception) {
+                napi_value error;
+                napi_get_and_clear_last_exception(env, &error);
+                firstError = firstError != nullptr ? firstError : error;
+            }
+        }
+    }
+    if (firstError != nullptr) {
+        napi_throw(env, firstError);
+    }
+}
+
+inline napi_value EventBus::dispatcher(napi_env env) {
+    if (!dispatcher_.empty()) {
+        return dispatcher_.value();
+    }
+    if (nativeDispatch_) {
+        return nullptr;
+    }
+    static constexpr const char *kBody = "let error, failed = false;"
+                                         "for (let i = 0; i < events.length; ++i) {"
+                                         "  const event = events[i];"
+                                         "  for (let j = 0; j < listeners.length; ++j) {"
+                                         "    try { listeners[j](event); }"
+                                         "    catch (e) { if (!failed) { failed = true; error = e; } }"
+                                         "  }"
+                                         "}"
+                                         "if (failed) throw error;";
+    napi_value argv[3];
+    napi_value ctor;
+    napi_value result;
+    NAPI_CHECK_STATUS(env, napi_create_string_utf8(env, "listeners", NAPI_AUTO_LENGTH, &argv[0]),
+                      "napi_create_string_utf8 failed");
+    NAPI_CHECK_STATUS(env, napi_create_string_utf8(env, "events", NAPI_AUTO_LENGTH, &argv[1]),
+                      "napi_create_string_utf8 failed");
+    NAPI_CHECK_STATUS(env, napi_create_string_utf8(env, kBody, NAPI_AUTO_LENGTH, &argv[2]),
+                      "napi_create_string_utf8 failed");
+    if (napi_get_named_property(env, Env(env).global(), "Function", &ctor) != napi_ok ||
+        napi_new_instance(env, ctor, 3, argv, &result) != napi_ok) {
+        // 运行环境禁止动态生成代码（如CSP或ArkTS的限制），清除异常并退回到Native分发
+        bool pendingException = false;
+        napi_is_exception_pending(env, &pendingException);
+        if (pendingException) {
+            napi_value error;
+            napi_get_and_clear_last_exception(env, &error);
+        }
+        nativeDispatch_ = true;
+        return nullptr;
+    }
+    dispatcher_ = UniqueReference<Function>::Create(Function(env, result), 1);
+    return result;
+}
+
+} // namespace tools
+} // namespace napi
+} // namespace OHOS
+
+#endif // OHOS_NAPI_EVENT_H
@@ -7,24 +7,276 @@
 namespace OHOS {
 namespace napi {
 
+/* -------------------------------- CallArena ------------------------------- */
+
+namespace tools {
+
+inline CallArena &CallArena::ThreadLocal() {
+    static thread_local CallArena arena;
+    return arena;
+}
+
+inline CallArena *CallArena::Current() {
+    CallArena &arena = ThreadLocal();
+    return arena.depth_ > 0 ? &arena : nullptr;
+}
+
+inline CallArena::Scope::Scope() : arena_(ThreadLocal()), block_(arena_.current_), used_(0) {
+    if (arena_.current_ != nullptr) {
+        used_ = arena_.current_->used;
+    }
+    ++arena_.depth_;
+}
+
+inline CallArena::Scope::~Scope() {
+    arena_.rewind(static_cast<Block *>(block_), used_);
+    if (--arena_.depth_ == 0) {
+        arena_.trimSpares();
+    }
+}
+
+inline CallArena::Pause::Pause() : arena_(ThreadLocal()), depth_(std::exchange(arena_.depth_, 0)) {}
+
+inline CallArena::Pause::~Pause() { arena_.depth_ = depth_; }
+
+inline CallArena::~CallArena() {
+    rewind(nullptr, 0);
+    spareBytes_ = 0;
+    trimSpares();
+}
+
+inline void *CallArena::allocate(std::size_t size, std::size_t alignment) {
+    for (;;) {
+        if (current_ != nullptr) {
+            auto base = reinterpret_cast<std::uintptr_t>(current_->data());
+            auto p = (base + current_->used + alignment - 1) & ~(static_cast<std::uintptr_t>(alignment) - 1);
+            if (p + size <= base + current_->capacity) {
+                current_->used = p + size - base;
+                return reinterpret_cast<void *>(p);
+            }
+        }
+        grow(size + alignment);
+    }
+}
+
+inline void CallArena::deallocate(void *p, std::size_t size) noexcept {
+    if (current_ != nullptr && static_cast<unsigned char *>(p) + size == current_->data() + current_->used) {
+        current_->used -= size;
+    }
+}
+
+inline std::size_t CallArena::bytesInUse() const {
+    std::size_t result = 0;
+    for (Block *block = current_; block != nullptr; block = block->prev) {
+        result += block->used;
+    }
+    return result;
+}
+
+inline void CallArena::grow(std::size_t minSize) {
+    // 优先复用空闲块
+    for (Block **link = &spares_; *link != nullptr; link = &(*link)->prev) {
+        Block *block = *link;
+        if (block->capacity >= minSize) {
+            *link = block->prev;
+            spareBytes_ -= block->capacity;
+            block->prev = current_;
+            block->used = 0;
+            current_ = block;
+            return;
+        }
+    }
+    std::size_t capacity = nextBlockSize_ > minSize ? nextBlockSize_ : minSize;
+    if (nextBlockSize_ < kMaxBlockSize) {
+        nextBlockSize_ <<= 1;
+    }
+    auto *block = static_cast<Block *>(::operator new(sizeof(Block) + capacity));
+    block->prev = current_;
+    block->capacity = capacity;
+    block->used = 0;
+    current_ = block;
+}
+
+inline void CallArena::rewind(Block *block, std::size_t used) {
+    while (current_ != nullptr && current_ != block) {
+        Block *released = current_;
+        current_ = released->prev;
+        released->prev = spares_;
+        spares_ = released;
+        spareBytes_ += released->capacity;
+    }
+    if (current_ != nullptr) {
+        current_->used = used;
+    }
+}
+
+inline void CallArena::trimSpares() {
+    while (spares_ != nullptr && spareBytes_ > kMaxSpareBytes) {
+        Block *block = spares_;
+        spares_ = block->prev;
+        spareBytes_ -= block->capacity;
+        ::operator delete(block);
+    }
+    if (spareBytes_ == 0) {
+        while (spares_ != nullptr) {
+            Block *block = spares_;
+            spares_ = block->prev;
+            ::operator delete(block);
+        }
+    }
+}
+
+} // namespace tools
+
+/* -------------------------------- HotValues ------------------------------- */
+
+namespace details {
+
+inline HotValues &HotValues::Current() {
+    static thread_local HotValues values;
+    return values;
+}
+
+inline HotValues *HotValues::For(napi_env env) {
+    HotValues &values = Current();
+    if (values.depth == 0) {
+        return nullptr;
+    }
+    if (values.env != env) {
+        std::uint32_t depth = values.depth;
+        values = HotValues();
+        values.env = env;
+        values.depth = depth;
+    }
+    return &values;
+}
+
+inline HotValueScope::HotValueScope() : saved_(HotValues::Current()) {
+    // 外层缓存的值属于外层的handle scope，本scope从空缓存开始
+    HotValues &values = HotValues::Current();
+    values = HotValues();
+    values.depth = saved_.depth + 1;
+}
+
+inline HotValueScope::~HotValueScope() { HotValues::Current() = saved_; }
+
+// 在HotValueScope内时先查缓存，未命中再通过getter获取并缓存
+template <typename Getter>
+inline napi_value GetHotValue(napi_env env, napi_value HotValues::*slot, Getter getter, const char *message) {
+    HotValues *hot = HotValues::For(env);
+    if (hot != nullptr && hot->*slot != nullptr) {
+        return hot->*slot;
+    }
+    napi_value value;
+    NAPI_CHECK_STATUS(env, getter(&value), message);
+    if (hot != nullptr) {
+        hot->*slot = value;
+    }
+    return value;
+}
+
+} // namespace details
+
+/* -------------------------------- EnvLocal -------------------------------- */
+
+namespace details {
+
+template <typename T> inline typename EnvLocal<T>::Registry &EnvLocal<T>::GetRegistry() {
+    // 有意不析构：进程退出时各env早已清理，避免静态析构顺序问题
+    static Registry *registry = new Registry();
+    return *registry;
+}
+
+template <typename T> inline T &EnvLocal<T>::Get(napi_env env) {
+    static thread_local Cache cache;
+    Registry &registry = GetRegistry();
+    // 先读generation再加锁：期间若有实例被析构，缓存记下的是旧值，下次访问自然失效
+    std::uint64_t generation = registry.generation.load(std::memory_order_acquire);
+    if (cache.env == env && cache.generation == generation) {
+        return *cache.instance;
+    }
+    std::unique_lock<std::mutex> lck(registry.mtx);
+    std::unique_ptr<T> &slot = registry.instances[env];
+    if (slot == nullptr) {
+        napi_status status = napi_add_env_cleanup_hook(env, Cleanup, env);
+        if (status != napi_ok) {
+            registry.instances.erase(env);
+            lck.unlock();
+            NAPI_CHECK_STATUS(env, status, "napi_add_env_cleanup_hook failed");
+        }
+        slot = std::make_unique<T>();
+    }
+    cache = Cache{env, slot.get(), generation};
+    return *slot;
+}
+
+template <typename T> inline void EnvLocal<T>::Cleanup(void *arg) {
+    Registry &registry = GetRegistry();
+    std::unique_ptr<T> instance; // 在锁外析构
+    {
+        std::lock_guard<std::mutex> lck(registry.mtx);
+        auto it = registry.instances.find(static_cast<napi_env>(arg));
+        if (it == registry.instances.end()) {
+            return;
+        }
+        instance = std::move(it->second);
+        registry.instances.erase(it);
+        registry.generation.fetch_add(1, std::memory_order_release);
+    }
+}
+
+// 每个env按名称缓存的构造函数
+struct ConstructorRegistry {
+    std::map<std::string, tools::Reference<Function>, std::less<>> constructors;
+};
+
+} // namespace details
+
 /* ---------------------------------- Env --------------------------------- */
 
 inline Value Env::global() const {
-    napi_value value;
-    NAPI_CHECK_STATUS(*this, napi_get_global(*this, &value), "Get global object failed");
-    return Value(*this, value);
+    napi_value result;
+    NAPI_CHECK_STATUS(env_, napi_get_global(env_, &result), "Get global object failed");
+    return Value(env_, result);
 }
 
 inline Value Env::undefined() const {
-    napi_value value;
-    NAPI_CHECK_STATUS(*this, napi_get_undefined(*this, &value), "Get undefined failed");
-    return Value(*this, value);
+    return Value(env_, details::GetHotValue(
+                           env_, &details::HotValues::undefined,
+                           [this](napi_value *result) { return napi_get_undefined(env_, result); },
+                           "Get undefined failed"));
 }
 
 inline Value Env::null() const {
-    napi_value value;
-    NAPI_CHECK_STATUS(*this, napi_get_null(*this, &value), "Get null failed");
-    return Value(*this, value);
+    return Value(env_, details::GetHotValue(
+                           env_, &details::HotValues::null,
+                           [this](napi_value *result) { return napi_get_null(env_, result); }, "Get null failed"));
+}
+
+inline Function Env::constructor(std::string_view name) const {
+    auto &constructors = details::EnvLocal<details::ConstructorRegistry>::Get(env_).constructors;
+    auto it = constructors.find(name);
+    if (it != constructors.end()) {
+        return it->second.value();
+    }
+    std::string key(name);
+    Value value = Object(env_, global()).get(key);
+    if (value.type() != napi_function) {
+        throw std::runtime_error("Constructor not found: " + key);
+    }
+    Function result(env_, value);
+    constructors.emplace(std::move(key), tools::Reference<Function>::Create(result, 1));
+    return result;
+}
+
+inline void Env::registerConstructor(std::string_view name, const Function &constructor) const {
+    auto &constructors = details::EnvLocal<details::ConstructorRegistry>::Get(env_).constructors;
+    auto it = constructors.find(name);
+    if (it != constructors.end()) {
+        it->second.reset(constructor, 1);
+    } else {
+        constructors.emplace(std::string(name), tools::Reference<Function>::Create(constructor, 1));
+    }
 }
 
 /* ---------------------------------- Value --------------------------------- */
@@ -59,14 +311,54 @@ inline bool Value::isArray() const {
     return result;
 }
 
+inline bool Value::isArrayBuffer() const {
+    if (isEmpty()) {
+        return false;
+    }
+    bool result;
+    NAPI_CHECK_STATUS(env_, napi_is_arraybuffer(env_, value_, &result), "napi_is_arraybuffer failed");
+    return result;
+}
+
+inline bool Value::isTypedArray() const {
+    if (isEmpty()) {
+        return false;
+    }
+    bool result;
+    NAPI_CHECK_STATUS(env_, napi_is_typedarray(env_, value_, &result), "napi_is_typedarray failed");
+    return result;
+}
+
+inline bool Value::isDataView() const {
+    if (isEmpty()) {
+        return false;
+    }
+    bool result;
+    NAPI_CHECK_STATUS(env_, napi_is_dataview(env_, value_, &result), "napi_is_dataview failed");
+    return result;
+}
+
+/* -------------------------------- Converter ------------------------------- */
+
 namespace details {
-template <typename T> struct vf_number {
-    static Number From(napi_env env, T value) { return Number::Create(env, static_cast<double>(value)); }
-};
+inline napi_valuetype TypeOf(napi_env env, napi_value value) {
+    napi_valuetype result;
+    NAPI_CHECK_STATUS(env, napi_typeof(env, value, &result), "Get value type failed");
+    return result;
+}
 
-template <> struct vf_number<bool> {
-    static Boolean From(napi_env env, bool value) { return Boolean::Create(env, value); }
-};
+inline bool IsNullish(napi_env env, napi_value value) {
+    napi_valuetype type = TypeOf(env, value);
+    return type == napi_undefined || type == napi_null;
+}
+
+inline bool IsArray(napi_env env, napi_value value) {
+    bool result;
+    NAPI_CHECK_STATUS(env, napi_is_array(env, value, &result), "napi_is_array failed");
+    return result;
+}
+
+inline napi_value Undefined(napi_env env) { return Env(env).undefined(); }
 
 struct vf_utf8_charp {
     static String From(napi_env env, const char *value) { return String::Create(env, value); }
@@ -76,33 +368,464 @@ struct vf_utf8_string {
     static String From(napi_env env, const std::string &value) { return String::Create(env, value); }
 };
 
-template <typename T> struct vf_fallback {
-    static Value From(napi_env env, const T &value) { return Value(env, value); }
+template <typename T> struct is_string_like : std::false_type {};
+template <> struct is_string_like<std::string> : std::true_type {};
+template <> struct is_string_like<std::string_view> : std::true_type {};
+template <> struct is_string_like<std::u16string> : std::true_type {};
+
+// value是否为type类型的TypedArray，是则取出其数据地址与元素个数
+template <typename T>
+inline bool TypedArrayData(napi_env env, napi_value value, napi_typedarray_type type, const T **data,
+                           std::size_t *length) {
+    bool isTypedArray;
+    NAPI_CHECK_STATUS(env, napi_is_typedarray(env, value, &isTypedArray), "napi_is_typedarray failed");
+    if (!isTypedArray) {
+        return false;
+    }
+    napi_typedarray_type actual;
+    void *raw;
+    NAPI_CHECK_STATUS(env, napi_get_typedarray_info(env, value, &actual, length, &raw, nullptr, nullptr),
+                      "napi_get_typedarray_info failed");
+    *data = static_cast<const T *>(raw);
+    return actual == type;
+}
+
+// 数组形式的转换：std::vector、std::array等
+template <typename Container> struct SequenceConverter {
+    using Element = typename Container::value_type;
+
+    static napi_value ToJS(napi_env env, const Container &value) {
+        napi_value result;
+        NAPI_CHECK_STATUS(env, napi_create_array_with_length(env, value.size(), &result), "Create array failed");
+        std::uint32_t index = 0;
+        for (const auto &element : value) {
+            NAPI_CHECK_STATUS(env, napi_set_element(env, result, index++, Converter<Element>::ToJS(env, element)),
+                              "napi_set_element failed");
+        }
+        return result;
+    }
+
+    static bool Is(napi_env env, napi_value value) {
+        if constexpr (HasTypedArray<Element>::value) {
+            const Element *data;
+            std::size_t length;
+            if (TypedArrayData(env, value, TypedArrayOf<Element>::kType, &data, &length)) {
+                return true;
+            }
+        }
+        return IsArray(env, value);
+    }
 };
 
-template <typename...> struct disjunction : std::false_type {};
-template <typename B> struct disjunction<B> : B {};
-template <typename B, typename... Bs>
-struct disjunction<B, Bs...> : std::conditional<bool(B::value), B, disjunction<Bs...>>::type {};
+// 对象形式的转换：std::map、std::unordered_map，key转换为属性名
+template <typename Map> struct MapConverter {
+    using Key = typename Map::key_type;
+    using Mapped = typename Map::mapped_type;
+
+    static napi_value ToJS(napi_env env, const Map &value) {
+        napi_value result;
+        NAPI_CHECK_STATUS(env, napi_create_object(env, &result), "Create object failed");
+        for (const auto &[key, mapped] : value) {
+            NAPI_CHECK_STATUS(
+                env, napi_set_property(env, result, Converter<Key>::ToJS(env, key), Converter<Mapped>::ToJS(env, mapped)),
+                "napi_set_property failed");
+        }
+        return result;
+    }
 
-template <typename T>
-struct can_make_string
-    : disjunction<
-          typename std::is_convertible<T, const char *>::type, typename std::is_convertible<T, const char16_t *>::type,
-          typename std::is_convertible<T, std::string>::type, typename std::is_convertible<T, std::u16string>::type> {};
+    static Map FromJS(napi_env env, napi_value value) {
+        napi_value keys;
+        NAPI_CHECK_STATUS(env, napi_get_property_names(env, value, &keys), "napi_get_property_names failed");
+        std::uint32_t length;
+        NAPI_CHECK_STATUS(env, napi_get_array_length(env, keys, &length), "napi_get_array_length failed");
+        Map result;
+        Reserve(result, length);
+        for (std::uint32_t i = 0; i < length; ++i) {
+            napi_value key;
+            napi_value mapped;
+            NAPI_CHECK_STATUS(env, napi_get_element(env, keys, i, &key), "napi_get_element failed");
+            NAPI_CHECK_STATUS(env, napi_get_property(env, value, key, &mapped), "napi_get_property failed");
+            if constexpr (std::is_arithmetic<Key>::value) {
+                // 属性名总是字符串，数值类型的key需要先转换为number
+                NAPI_CHECK_STATUS(env, napi_coerce_to_number(env, key, &key), "napi_coerce_to_number failed");
+            }
+            result.emplace(Converter<Key>::FromJS(env, key), Converter<Mapped>::FromJS(env, mapped));
+        }
+        return result;
+    }
+
+    static bool Is(napi_env env, napi_value value) { return TypeOf(env, value) == napi_object; }
+
+private:
+    template <typename M> static auto Reserve(M &map, std::size_t n) -> decltype(map.reserve(n), void()) {
+        map.reserve(n);
+    }
+    static void Reserve(...) {}
+};
+
+// 定长数组形式的转换：std::pair、std::tuple
+template <typename Tuple> struct TupleConverter {
+    static constexpr std::size_t kSize = std::tuple_size<Tuple>::value;
+
+    static napi_value ToJS(napi_env env, const Tuple &value) {
+        napi_value result;
+        NAPI_CHECK_STATUS(env, napi_create_array_with_length(env, kSize, &result), "Create array failed");
+        SetElements(env, result, value, std::make_index_sequence<kSize>());
+        return result;
+    }
+
+    static Tuple FromJS(napi_env env, napi_value value) {
+        return GetElements(env, value, std::make_index_sequence<kSize>());
+    }
+
+    static bool Is(napi_env env, napi_value value) { return IsArray(env, value); }
+
+private:
+    template <std::size_t I> static void SetElement(napi_env env, napi_value array, const Tuple &value) {
+        napi_value element = Converter<std::tuple_element_t<I, Tuple>>::ToJS(env, std::get<I>(value));
+        NAPI_CHECK_STATUS(env, napi_set_element(env, array, I, element), "napi_set_element failed");
+    }
+
+    template <std::size_t... I>
+    static void SetElements(napi_env env, napi_value array, const Tuple &value, std::index_sequence<I...>) {
+        (SetElement<I>(env, array, value), ...);
+    }
+
+    template <std::size_t I> static std::tuple_element_t<I, Tuple> GetElement(napi_env env, napi_value array) {
+        napi_value element;
+        NAPI_CHECK_STATUS(env, napi_get_element(env, array, I, &element), "napi_get_element failed");
+        return Converter<std::tuple_element_t<I, Tuple>>::FromJS(env, element);
+    }
+
+    template <std::size_t... I> static Tuple GetElements(napi_env env, napi_value array, std::index_sequence<I...>) {
+        return Tuple{GetElement<I>(env, array)...};
+    }
+};
 } // namespace details
 
-// clang-format off
+// JS值包装类：直接透传
+template <typename T> struct Converter<T, typename std::enable_if<std::is_base_of<Value, T>::value>::type> {
+    static napi_value ToJS(napi_env, const T &value) { return value; }
+    static T FromJS(napi_env env, napi_value value) { return T(env, value); }
+    static bool Is(napi_env env, napi_value value) {
+        if constexpr (std::is_same<T, Boolean>::value) {
+            return details::TypeOf(env, value) == napi_boolean;
+        } else if constexpr (std::is_same<T, Number>::value) {
+            return details::TypeOf(env, value) == napi_number;
+        } else if constexpr (std::is_same<T, BigInt>::value) {
+            return details::TypeOf(env, value) == napi_bigint;
+        } else if constexpr (std::is_same<T, String>::value) {
+            return details::TypeOf(env, value) == napi_string;
+        } else if constexpr (std::is_same<T, Function>::value) {
+            return details::TypeOf(env, value) == napi_function;
+        } else if constexpr (std::is_same<T, Array>::value) {
+            return details::IsArray(env, value);
+        } else if constexpr (std::is_same<T, ArrayBuffer>::value) {
+            return Value(env, value).isArrayBuffer();
+        } else if constexpr (std::is_same<T, TypedArray>::value) {
+            return Value(env, value).isTypedArray();
+        } else if constexpr (std::is_same<T, DataView>::value) {
+            return Value(env, value).isDataView();
+        } else if constexpr (std::is_base_of<TypedArray, T>::value) {
+            return Value(env, value).isTypedArray() && TypedArray(env, value).typedArrayType() == T::kType;
+        } else if constexpr (std::is_base_of<Object, T>::value) {
+            return Value(env, value).isObject();
+        } else {
+            return true;
+        }
+    }
+};
+
+// 可隐式转换为Value的类型，如Object::PropertyLValue
+template <typename T>
+struct Converter<T, typename std::enable_if<!std::is_base_of<Value, T>::value && std::is_class<T>::value &&
+                                            std::is_convertible<T, Value>::value>::type> {
+    static napi_value ToJS(napi_env, const T &value) { return Value(value); }
+};
+
+template <> struct Converter<napi_value> {
+    static napi_value ToJS(napi_env, napi_value value) { return value; }
+    static napi_value FromJS(napi_env, napi_value value) { return value; }
+    static bool Is(napi_env, napi_value) { return true; }
+};
+
+template <> struct Converter<bool> {
+    static napi_value ToJS(napi_env env, bool value) { return Boolean::Create(env, value); }
+    static bool FromJS(napi_env env, napi_value value) { return Boolean(env, value).asBool(); }
+    static bool Is(napi_env env, napi_value value) { return details::TypeOf(env, value) == napi_boolean; }
+};
+
+// 整数：按位宽与符号精确分派到int32/uint32/int64，64位整数的FromJS同时接受BigInt
+template <typename T>
+struct Converter<T, typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value>::type> {
+    static napi_value ToJS(napi_env env, T value) {
+        napi_value result;
+        if constexpr (sizeof(T) <= sizeof(std::int32_t) && std::is_signed<T>::value) {
+            NAPI_CHECK_STATUS(env, napi_create_int32(env, value, &result), "Failed to create int32");
+        } else if constexpr (sizeof(T) <= sizeof(std::uint32_t)) {
+            NAPI_CHECK_STATUS(env, napi_create_uint32(env, value, &result), "Failed to create uint32");
+        } else if constexpr (std::is_signed<T>::value) {
+            NAPI_CHECK_STATUS(env, napi_create_int64(env, value, &result), "Failed to create int64");
+        } else if (value <= static_cast<std::uint64_t>(INT64_MAX)) {
+            NAPI_CHECK_STATUS(env, napi_create_int64(env, static_cast<std::int64_t>(value), &result),
+                              "Failed to create int64");
+        } else {
+            NAPI_CHECK_STATUS(env, napi_create_double(env, static_cast<double>(value), &result),
+                              "Failed to create double");
+        }
+        return result;
+    }
+
+    static T FromJS(napi_env env, napi_value value) {
+        if constexpr (sizeof(T) <= sizeof(std::int32_t) && std::is_signed<T>::value) {
+            std::int32_t result;
+            NAPI_CHECK_STATUS(env, napi_get_value_int32(env, value, &result), "Convert napi_value to int32_t failed");
+            return static_cast<T>(result);
+        } else if constexpr (sizeof(T) <= sizeof(std::uint32_t)) {
+            std::uint32_t result;
+            NAPI_CHECK_STATUS(env, napi_get_value_uint32(env, value, &result), "Convert napi_value to uint32_t failed");
+            return static_cast<T>(result);
+        } else if constexpr (std::is_signed<T>::value) {
+            std::int64_t result;
+            napi_status status = napi_get_value_int64(env, value, &result);
+            if (status == napi_number_expected) {
+                bool lossless;
+                status = napi_get_value_bigint_int64(env, value, &result, &lossless);
+            }
+            NAPI_CHECK_STATUS(env, status, "Convert napi_value to int64_t failed");
+            return static_cast<T>(result);
+        } else {
+            double number;
+            napi_status status = napi_get_value_double(env, value, &number);
+            if (status == napi_number_expected) {
+                std::uint64_t result;
+                bool lossless;
+                NAPI_CHECK_STATUS(env, napi_get_value_bigint_uint64(env, value, &result, &lossless),
+                                  "Convert napi_value to uint64_t failed");
+                return static_cast<T>(result);
+            }
+            NAPI_CHECK_STATUS(env, status, "Convert napi_value to uint64_t failed");
+            // 超出范围的double转换为整数是未定义行为：NaN与负数取0，过大的值取T的最大值
+            if (std::isnan(number) || number <= 0) {
+                return 0;
+            }
+            if (number >= static_cast<double>(std::numeric_limits<T>::max())) {
+                return std::numeric_limits<T>::max();
+            }
+            return static_cast<T>(number);
+        }
+    }
+
+    static bool Is(napi_env env, napi_value value) {
+        napi_valuetype type = details::TypeOf(env, value);
+        return type == napi_number || (sizeof(T) > sizeof(std::int32_t) && type == napi_bigint);
+    }
+};
+
+template <typename T> struct Converter<T, typename std::enable_if<std::is_floating_point<T>::value>::type> {
+    static napi_value ToJS(napi_env env, T value) {
+        napi_value result;
+        NAPI_CHECK_STATUS(env, napi_create_double(env, static_cast<double>(value), &result), "Failed to create double");
+        return result;
+    }
+    static T FromJS(napi_env env, napi_value value) {
+        double result;
+        NAPI_CHECK_STATUS(env, napi_get_value_double(env, value, &result), "Convert napi_value to double failed");
+        return static_cast<T>(result);
+    }
+    static bool Is(napi_env env, napi_value value) { return details::TypeOf(env, value) == napi_number; }
+};
+
+#ifdef __SIZEOF_INT128__
+// 128位整数：总是转换为BigInt，FromJS也接受number
+template <typename T> struct Int128Converter {
+    static napi_value ToJS(napi_env env, T value) { return BigInt::Create(env, value); }
+    static T FromJS(napi_env env, napi_value value) {
+        if (details::TypeOf(env, value) == napi_number) {
+            std::int64_t result;
+            NAPI_CHECK_STATUS(env, napi_get_value_int64(env, value, &result), "Convert napi_value to int64_t failed");
+            return static_cast<T>(result);
+        }
+        if constexpr (std::is_same<T, __int128>::value) {
+            return BigInt(env, value).asInt128();
+        } else {
+            return BigInt(env, value).asUint128();
+        }
+    }
+    static bool Is(napi_env env, napi_value value) {
+        napi_valuetype type = details::TypeOf(env, value);
+        return type == napi_number || type == napi_bigint;
+    }
+};
+
+template <> struct Converter<__int128> : Int128Converter<__int128> {};
+template <> struct Converter<unsigned __int128> : Int128Converter<unsigned __int128> {};
+#endif
+
+// 枚举：按底层整数类型转换
+template <typename T> struct Converter<T, typename std::enable_if<std::is_enum<T>::value>::type> {
+    using Underlying = typename std::underlying_type<T>::type;
+
+    static napi_value ToJS(napi_env env, T value) {
+        return Converter<Underlying>::ToJS(env, static_cast<Underlying>(value));
+    }
+    static T FromJS(napi_env env, napi_value value) { return static_cast<T>(Converter<Underlying>::FromJS(env, value)); }
+    static bool Is(napi_env env, napi_value value) { return Converter<Underlying>::Is(env, value); }
+};
+
+template <> struct Converter<std::string> {
+    static napi_value ToJS(napi_env env, const std::string &value) { return String::Create(env, value); }
+    static std::string FromJS(napi_env env, napi_value value) { return String(env, value).asString(); }
+    static bool Is(napi_env env, napi_value value) { return details::TypeOf(env, value) == napi_string; }
+};
+
+// @note FromJS的结果分配在当前的CallArena上，见String::asStringView。
+// 没有活动的CallArena时结果无处存放，抛出std::logic_error，此时应改用std::string
+template <> struct Converter<std::string_view> {
+    static napi_value ToJS(napi_env env, std::string_view value) {
+        return String::Create(env, value.data(), value.size());
+    }
+    static std::string_view FromJS(napi_env env, napi_value value) {
+        if (tools::CallArena::Current() == nullptr) {
+            throw std::logic_error("Converting to std::string_view requires an active CallArena");
+        }
+        return String(env, value).asStringView();
+    }
+    static bool Is(napi_env env, napi_value value) { return details::TypeOf(env, value) == napi_string; }
+};
+
+template <> struct Converter<std::u16string> {
+    static napi_value ToJS(napi_env env, const std::u16string &value) {
+        napi_value result;
+        NAPI_CHECK_STATUS(env, napi_create_string_utf16(env, value.data(), value.size(), &result),
+                          "napi_create_string_utf16 failed");
+        return result;
+    }
+    static std::u16string FromJS(napi_env env, napi_value value) {
+        std::size_t length;
+        NAPI_CHECK_STATUS(env, napi_get_value_string_utf16(env, value, nullptr, 0, &length),
+                          "Get string length failed");
+        std::u16string result(length, u'\0');
+        NAPI_CHECK_STATUS(env, napi_get_value_string_utf16(env, value, &result[0], length + 1, nullptr),
+                          "Convert napi_value to u16string failed");
+        return result;
+    }
+    static bool Is(napi_env env, napi_value value) { return details::TypeOf(env, value) == napi_string; }
+};
+
+template <> struct Converter<const char *> {
+    static napi_value ToJS(napi_env env, const char *value) {
+        return String::Create(env, value, NAPI_AUTO_LENGTH);
+    }
+};
+template <> struct Converter<char *> : Converter<const char *> {};
+template <std::size_t N> struct Converter<char[N]> : Converter<const char *> {};
+
+template <> struct Converter<const char16_t *> {
+    static napi_value ToJS(napi_env env, const char16_t *value) {
+        napi_value result;
+        NAPI_CHECK_STATUS(env, napi_create_string_utf16(env, value, NAPI_AUTO_LENGTH, &result),
+                          "napi_create_string_utf16 failed");
+        return result;
+    }
+};
+template <> struct Converter<char16_t *> : Converter<const char16_t *> {};
+template <std::size_t N> struct Converter<char16_t[N]> : Converter<const char16_t *> {};
+
+template <> struct Converter<std::monostate> {
+    static napi_value ToJS(napi_env env, std::monostate) { return details::Undefined(env); }
+    static std::monostate FromJS(napi_env, napi_value) { return {}; }
+    static bool Is(napi_env env, napi_value value) { return details::IsNullish(env, value); }
+};
+
+// std::nullopt <-> undefined，FromJS时null也视为std::nullopt
+template <typename T> struct Converter<std::optional<T>> {
+    static napi_value ToJS(napi_env env, const std::optional<T> &value) {
+        return value.has_value() ? Converter<T>::ToJS(env, *value) : details::Undefined(env);
+    }
+    static std::optional<T> FromJS(napi_env env, napi_value value) {
+        if (details::IsNullish(env, value)) {
+            return std::nullopt;
+        }
+        return Converter<T>::FromJS(env, value);
+    }
+    static bool Is(napi_env env, napi_value value) {
+        return details::IsNullish(env, value) || Converter<T>::Is(env, value);
+    }
+};
+
+template <typename T, typename Alloc>
+struct Converter<std::vector<T, Alloc>> : details::SequenceConverter<std::vector<T, Alloc>> {
+    static std::vector<T, Alloc> FromJS(napi_env env, napi_value value) {
+        if constexpr (details::HasTypedArray<T>::value) {
+            // 元素类型相同的TypedArray整块拷贝，BigInt64Array不必逐个读取BigInt
+            const T *data;
+            std::size_t length;
+            if (details::TypedArrayData(env, value, TypedArrayOf<T>::kType, &data, &length)) {
+                return std::vector<T, Alloc>(data, data + length);
+            }
+        }
+        std::uint32_t length;
+        NAPI_CHECK_STATUS(env, napi_get_array_length(env, value, &length), "napi_get_array_length failed");
+        std::vector<T, Alloc> result;
+        result.reserve(length);
+        for (std::uint32_t i = 0; i < length; ++i) {
+            napi_value element;
+            NAPI_CHECK_STATUS(env, napi_get_element(env, value, i, &element), "napi_get_element failed");
+            result.push_back(Converter<T>::FromJS(env, element));
+        }
+        return result;
+    }
+};
+
+template <typename T, std::size_t N> struct Converter<std::array<T, N>> : details::SequenceConverter<std::array<T, N>> {
+    static std::array<T, N> FromJS(napi_env env, napi_value value) {
+        std::array<T, N> result;
+        for (std::uint32_t i = 0; i < N; ++i) {
+            napi_value element;
+            NAPI_CHECK_STATUS(env, napi_get_element(env, value, i, &element), "napi_get_element failed");
+            result[i] = Converter<T>::FromJS(env, element);
+        }
+        return result;
+    }
+};
+
+template <typename K, typename V, typename... Rest>
+struct Converter<std::map<K, V, Rest...>> : details::MapConverter<std::map<K, V, Rest...>> {};
+template <typename K, typename V, typename... Rest>
+struct Converter<std::unordered_map<K, V, Rest...>> : details::MapConverter<std::unordered_map<K, V, Rest...>> {};
+
+template <typename A, typename B> struct Converter<std::pair<A, B>> : details::TupleConverter<std::pair<A, B>> {};
+template <typename... Ts> struct Converter<std::tuple<Ts...>> : details::TupleConverter<std::tuple<Ts...>> {};
+
+// std::variant：ToJS转换当前持有的值，FromJS按声明顺序选择第一个Is()匹配的类型
+template <typename... Ts> struct Converter<std::variant<Ts...>> {
+    static napi_value ToJS(napi_env env, const std::variant<Ts...> &value) {
+        return std::visit(
+            [env](const auto &alternative) {
+                return Converter<std::decay_t<decltype(alternative)>>::ToJS(env, alternative);
+            },
+            value);
+    }
+    static std::variant<Ts...> FromJS(napi_env env, napi_value value) {
+        std::optional<std::variant<Ts...>> result;
+        ((!result && Converter<Ts>::Is(env, value) ? (result.emplace(Converter<Ts>::FromJS(env, value)), true)
+                                                   : false),
+         ...);
+        if (!result) {
+            throw std::runtime_error("No matching alternative for std::variant");
+        }
+        return std::move(*result);
+    }
+    static bool Is(napi_env env, napi_value value) { return (Converter<Ts>::Is(env, value) || ...); }
+};
+
 template <typename T> inline Value Value::From(napi_env env, const T &value) {
-  using Helper = typename std::conditional<
-      std::is_integral<T>::value || std::is_floating_point<T>::value,
-      details::vf_number<T>,
-      typename std::conditional<details::can_make_string<T>::value,
-                                String,
-                                details::vf_fallback<T>>::type>::type;
-    return Helper::From(env, value);
+    return Value(env, Converter<T>::ToJS(env, value));
 }
 
+// clang-format off
+
 template <typename T> inline String String::From(napi_env env, const T& value) {
   struct Dummy {};
   using Helper = typename std::conditional<
@@ -121,6 +844,10 @@ inline typename std::enable_if<std::is_base_of<Value, NapiValue>::value, NapiVal
     return NapiValue(env_, value_);
 }
 
+template <typename T> inline typename std::enable_if<!std::is_base_of<Value, T>::value, T>::type Value::as() const {
+    return Converter<T>::FromJS(env_, value_);
+}
+
 inline Boolean Value::toBoolean() const {
     napi_value result;
     NAPI_CHECK_STATUS(env_, napi_coerce_to_bool(env_, value_, &result), "napi_coerce_to_bool failed");
@@ -148,12 +875,14 @@ inline Object Value::toObject() const {
 /* --------------------------------- Boolean -------------------------------- */
 
 inline Boolean Boolean::Create(napi_env env, bool value) {
-    napi_value result;
-    NAPI_CHECK_STATUS(env, napi_get_boolean(env, value, &result), "napi_get_boolean");
-    return Boolean(env, result);
+    return Boolean(env, details::GetHotValue(
+                            env, value ? &details::HotValues::trueValue : &details::HotValues::falseValue,
+                            [env, value](napi_value *result) { return napi_get_boolean(env, value, result); },
+                            "napi_get_boolean"));
 }
 
-inline Boolean::operator bool() const {
+inline Boolean::operator bool() const { return asBool(); }
+inline bool Boolean::asBool() const {
     bool result;
     NAPI_CHECK_STATUS(env_, napi_get_value_bool(env_, value_, &result), "napi_get_value_bool");
     return result;
@@ -214,6 +943,25 @@ inline std::int64_t Number::asInt64() const {
     return result;
 }
 
+/* --------------------------------- TypeTag -------------------------------- */
+
+namespace tools {
+template <typename T> inline const TypeTag &TypeTagOf() {
+    // 以两个不同的初值对类型名做FNV-1a，得到128位标记
+    static const TypeTag tag = [] {
+        const char *name = typeid(T).name();
+        std::uint64_t lower = 0xcbf29ce484222325ULL;
+        std::uint64_t upper = 0x84222325cbf29ce4ULL;
+        for (const char *p = name; *p != '\0'; ++p) {
+            lower = (lower ^ static_cast<unsigned char>(*p)) * 0x100000001b3ULL;
+            upper = (upper ^ static_cast<unsigned char>(*p)) * 0x100000001b3ULL;
+        }
+        return TypeTag{lower, upper};
+    }();
+    return tag;
+}
+} // namespace tools
+
 /* --------------------------------- BigInt --------------------------------- */
 
 inline BigInt BigInt::Create(napi_env env, std::int64_t value) {
@@ -235,6 +983,33 @@ inline BigInt BigInt::Create(napi_env env, int signBit, std::size_t wordCount, c
     return BigInt(env, result);
 }
 
+template <std::size_t N> inline BigInt BigInt::Create(napi_env env, const Words<N> &words) {
+    return Create(env, words.signBit, std::min(words.count, N), words.data.data());
+}
+
+#ifdef __SIZEOF_INT128__
+inline BigInt BigInt::Create(napi_env env, __int128 value) {
+    if (value >= INT64_MIN && value <= INT64_MAX) {
+        return Create(env, static_cast<std::int64_t>(value));
+    }
+    // 补码转为符号+绝对值，-2^127取反加一后按无符号解释仍是正确的绝对值
+    auto magnitude = static_cast<unsigned __int128>(value);
+    if (value < 0) {
+        magnitude = ~magnitude + 1;
+    }
+    const std::uint64_t words[2] = {static_cast<std::uint64_t>(magnitude), static_cast<std::uint64_t>(magnitude >> 64)};
+    return Create(env, value < 0 ? 1 : 0, 2, words);
+}
+
+inline BigInt BigInt::Create(napi_env env, unsigned __int128 value) {
+    if (value <= UINT64_MAX) {
+        return Create(env, static_cast<std::uint64_t>(value));
+    }
+    const std::uint64_t words[2] = {static_cast<std::uint64_t>(value), static_cast<std::uint64_t>(value >> 64)};
+    return Create(env, 0, 2, words);
+}
+#endif
+
 inline std::int64_t BigInt::asInt64(bool *lossless) const {
     std::int64_t result;
     NAPI_CHECK_STATUS(env_, napi_get_value_bigint_int64(env_, value_, &result, lossless),
@@ -261,6 +1036,34 @@ inline void BigInt::toWords(int *signBit, std::size_t *wordCount, std::uint64_t
                       "Failed to get bigint words");
 }
 
+template <std::size_t N> inline BigInt::Words<N> BigInt::toWords() const {
+    Words<N> result;
+    result.count = N;
+    toWords(&result.signBit, &result.count, result.data.data());
+    return result;
+}
+
+#ifdef __SIZEOF_INT128__
+inline __int128 BigInt::asInt128(bool *lossless) const {
+    auto words = toWords<2>();
+    auto magnitude = (static_cast<unsigned __int128>(words.data[1]) << 64) | words.data[0];
+    if (lossless != nullptr) {
+        constexpr auto kMaxPositive = ~static_cast<unsigned __int128>(0) >> 1;
+        *lossless = !words.truncated() && magnitude <= kMaxPositive + (words.signBit ? 1 : 0);
+    }
+    return static_cast<__int128>(words.signBit ? ~magnitude + 1 : magnitude);
+}
+
+inline unsigned __int128 BigInt::asUint128(bool *lossless) const {
+    auto words = toWords<2>();
+    auto magnitude = (static_cast<unsigned __int128>(words.data[1]) << 64) | words.data[0];
+    if (lossless != nullptr) {
+        *lossless = !words.truncated() && (words.signBit == 0 || magnitude == 0);
+    }
+    return words.signBit ? ~magnitude + 1 : magnitude;
+}
+#endif
+
 /* --------------------------------- Object --------------------------------- */
 
 inline Object Object::Create(napi_env env) {
@@ -301,12 +1104,12 @@ inline bool Object::hasOwnProperty(const std::string &utf8name) const {
     return hasOwnProperty(String::Create(env_, utf8name).value());
 }
 
-inline Object::PropertyLValue<std::string> Object::operator[](const char *utf8name) {
-    return PropertyLValue<std::string>(*this, utf8name);
+inline Object::PropertyLValue<tools::ArenaString> Object::operator[](const char *utf8name) {
+    return PropertyLValue<tools::ArenaString>(*this, tools::ArenaString(utf8name));
 }
 
-inline Object::PropertyLValue<std::string> Object::operator[](const std::string &utf8name) {
-    return PropertyLValue<std::string>(*this, utf8name);
+inline Object::PropertyLValue<tools::ArenaString> Object::operator[](const std::string &utf8name) {
+    return PropertyLValue<tools::ArenaString>(*this, tools::ArenaString(utf8name.data(), utf8name.size()));
 }
 
 inline Object::PropertyLValue<std::uint32_t> Object::operator[](std::uint32_t index) {
@@ -450,6 +1253,64 @@ inline bool Object:: instanceof (const Function &constructor) const {
     return result;
 }
 
+inline bool Object:: instanceof (std::string_view constructorName) const {
+    return instanceof (Env(env_).constructor(constructorName));
+}
+
+namespace details {
+#if !NAPI_FRAMEWORK_HAS_TYPE_TAG
+// 不支持napi_type_tag_object时，每个标记对应一个按env缓存的Symbol，标记即定义以它为键的不可枚举属性
+struct TypeTagSymbols {
+    std::map<tools::TypeTag, tools::Reference<Value>> symbols;
+
+    napi_value get(napi_env env, const tools::TypeTag &tag) {
+        auto it = symbols.find(tag);
+        if (it != symbols.end()) {
+            return it->second.value();
+        }
+        napi_value description;
+        napi_value symbol;
+        NAPI_CHECK_STATUS(env, napi_create_string_utf8(env, "napi.typeTag", NAPI_AUTO_LENGTH, &description),
+                          "napi_create_string_utf8 failed");
+        NAPI_CHECK_STATUS(env, napi_create_symbol(env, description, &symbol), "napi_create_symbol failed");
+        symbols.emplace(tag, tools::Reference<Value>::Create(Value(env, symbol), 1));
+        return symbol;
+    }
+};
+#endif
+} // namespace details
+
+inline void Object::typeTag(const tools::TypeTag &tag) const {
+#if NAPI_FRAMEWORK_HAS_TYPE_TAG
+    const napi_type_tag napiTag{tag.lower, tag.upper};
+    NAPI_CHECK_STATUS(env_, napi_type_tag_object(env_, value_, &napiTag), "napi_type_tag_object failed");
+#else
+    napi_value symbol = details::EnvLocal<details::TypeTagSymbols>::Get(env_).get(env_, tag);
+    if (checkTypeTag(tag)) {
+        throw std::runtime_error("Object has already been type tagged");
+    }
+    napi_property_descriptor descriptor{nullptr, symbol,  nullptr, nullptr, nullptr, Boolean::Create(env_, true),
+                                        napi_default, nullptr};
+    NAPI_CHECK_STATUS(env_, napi_define_properties(env_, value_, 1, &descriptor), "napi_define_properties failed");
+#endif
+}
+
+inline bool Object::checkTypeTag(const tools::TypeTag &tag) const {
+    bool result = false;
+#if NAPI_FRAMEWORK_HAS_TYPE_TAG
+    const napi_type_tag napiTag{tag.lower, tag.upper};
+    napi_status status = napi_check_object_type_tag(env_, value_, &napiTag, &result);
+#else
+    napi_value symbol = details::EnvLocal<details::TypeTagSymbols>::Get(env_).get(env_, tag);
+    napi_status status = napi_has_own_property(env_, value_, symbol, &result);
+#endif
+    if (status == napi_object_expected) {
+        return false;
+    }
+    NAPI_CHECK_STATUS(env_, status, "Check object type tag failed");
+    return result;
+}
+
 inline bool Object::freeze() const {
     NAPI_CHECK_STATUS(env_, napi_object_freeze(env_, value_), "napi_object_freeze failed");
     return true;
@@ -460,7 +1321,59 @@ inline bool Object::seal() const {
     return true;
 }
 
-/* --------------------------------- String --------------------------------- */
+namespace details {
+// Object::wrap绑定到JS对象上的数据
+struct WrapBox {
+    void *native;
+    void (*deleter)(void *);
+    bool onJSThread;
+    tools::Accounted accounted;
+
+    // 在JS线程上扣除记账，析构按FinalizeOnJSThread决定就地执行还是交给Reclaimer
+    static void Finalize(napi_env, void *data, void *) {
+        auto *box = static_cast<WrapBox *>(data);
+        box->accounted.reset();
+        if (box->onJSThread) {
+            box->deleter(box->native);
+        } else {
+            tools::Reclaimer::Instance().retire(box->native, box->deleter);
+        }
+        delete box;
+    }
+};
+} // namespace details
+
+template <typename T> inline void Object::wrap(T *native, std::size_t byteLength, const char *category) const {
+    auto *box = new details::WrapBox{native, [](void *p) { delete static_cast<T *>(p); },
+                                     tools::FinalizeOnJSThread<T>::value, {}};
+    napi_status status = napi_wrap(env_, value_, box, details::WrapBox::Finalize, nullptr, nullptr);
+    if (status != napi_ok) {
+        delete box;
+        NAPI_CHECK_STATUS(env_, status, "napi_wrap failed");
+    }
+    box->accounted = tools::Accounted(env_, category, byteLength);
+}
+
+template <typename T> inline T *Object::unwrap() const {
+    void *data = nullptr;
+    if (napi_unwrap(env_, value_, &data) != napi_ok || data == nullptr) {
+        return nullptr;
+    }
+    return static_cast<T *>(static_cast<details::WrapBox *>(data)->native);
+}
+
+template <typename T> inline std::unique_ptr<T> Object::removeWrap() const {
+    void *data = nullptr;
+    if (napi_remove_wrap(env_, value_, &data) != napi_ok || data == nullptr) {
+        return nullptr;
+    }
+    auto *box = static_cast<details::WrapBox *>(data);
+    std::unique_ptr<T> native(static_cast<T *>(box->native));
+    delete box;
+    return native;
+}
+
+/* --------------------------------- String --------------------------------- */
 
 inline String String::Create(napi_env env, const char *str, std::size_t length) {
     napi_value value;
@@ -492,6 +1405,21 @@ inline std::string String::asString() const {
     return result;
 }
 
+inline std::string_view String::asStringView() const {
+    std::size_t length;
+    NAPI_CHECK_STATUS(env_, napi_get_value_string_utf8(env_, value_, nullptr, 0, &length), "Get string length failed");
+    char *buffer;
+    if (tools::CallArena *arena = tools::CallArena::Current()) {
+        buffer = static_cast<char *>(arena->allocate(length + 1, alignof(char)));
+    } else {
+        results_.emplace_front(length, '\0');
+        buffer = &results_.front()[0];
+    }
+    NAPI_CHECK_STATUS(env_, napi_get_value_string_utf8(env_, value_, buffer, length + 1, nullptr),
+                      "Convert napi_value to string failed");
+    return std::string_view(buffer, length);
+}
+
 /* -------------------------------- Function -------------------------------- */
 
 inline Function Function::Create(napi_env env, const char *utf8name, napi_callback callback, void *data) {
@@ -508,6 +1436,128 @@ inline Function Function::Create(napi_env env, const std::string &utf8name, napi
     return Function(env, result);
 }
 
+namespace details {
+inline void *ClosureBlockPool::Acquire() {
+    FreeList &list = Local();
+    if (list.head == nullptr) {
+        return ::operator new(kBlockSize);
+    }
+    Node *node = list.head;
+    list.head = node->next;
+    --list.count;
+    return node;
+}
+
+inline void ClosureBlockPool::Release(void *block) {
+    FreeList &list = Local();
+    if (list.count >= kMaxCached) {
+        ::operator delete(block);
+        return;
+    }
+    auto *node = static_cast<Node *>(block);
+    node->next = list.head;
+    list.head = node;
+    ++list.count;
+}
+
+inline ClosureBlockPool::FreeList::~FreeList() {
+    while (head != nullptr) {
+        Node *node = head;
+        head = node->next;
+        ::operator delete(node);
+    }
+}
+
+inline ClosureBlockPool::FreeList &ClosureBlockPool::Local() {
+    static thread_local FreeList list;
+    return list;
+}
+
+template <typename F> struct Closure {
+    static constexpr bool kInline =
+        sizeof(F) <= ClosureBlockPool::kBlockSize && alignof(F) <= alignof(std::max_align_t);
+
+    template <typename Callable> static F *New(Callable &&callable) {
+        if constexpr (kInline) {
+            void *block = ClosureBlockPool::Acquire();
+            try {
+                return new (block) F(std::forward<Callable>(callable));
+            } catch (...) {
+                ClosureBlockPool::Release(block);
+                throw;
+            }
+        } else {
+            return new F(std::forward<Callable>(callable));
+        }
+    }
+
+    static void Delete(F *closure) {
+        if constexpr (kInline) {
+            closure->~F();
+            ClosureBlockPool::Release(closure);
+        } else {
+            delete closure;
+        }
+    }
+
+    static void Finalize(napi_env, void *data, void *) { Delete(static_cast<F *>(data)); }
+
+    static napi_value Trampoline(napi_env env, napi_callback_info info) {
+        void *data = nullptr;
+        if (napi_get_cb_info(env, info, nullptr, nullptr, nullptr, &data) != napi_ok) {
+            return nullptr;
+        }
+        F &closure = *static_cast<F *>(data);
+        tools::CallArena::Scope arenaScope;
+        HotValueScope hotValueScope;
+        try {
+            if constexpr (std::is_invocable<F &, const CallbackInfo &>::value) {
+                CallbackInfo cbInfo(env, info, 0);
+                return Invoke(env, closure, cbInfo);
+            } else {
+                return Invoke(env, closure);
+            }
+        } catch (const std::exception &e) {
+            napi_throw_error(env, nullptr, e.what());
+        } catch (...) {
+            napi_throw_error(env, nullptr, "unknown native exception");
+        }
+        return nullptr;
+    }
+
+    template <typename... Args> static napi_value Invoke(napi_env env, F &closure, Args &...args) {
+        using R = std::decay_t<std::invoke_result_t<F &, Args &...>>;
+        if constexpr (std::is_void<R>::value) {
+            closure(args...);
+            return Undefined(env);
+        } else {
+            return Converter<R>::ToJS(env, closure(args...));
+        }
+    }
+};
+} // namespace details
+
+template <typename Callable, typename>
+inline Function Function::Create(napi_env env, const char *utf8name, Callable &&callable) {
+    using Closure = details::Closure<std::decay_t<Callable>>;
+    auto *closure = Closure::New(std::forward<Callable>(callable));
+    napi_value result;
+    napi_status status = napi_create_function(env, utf8name, NAPI_AUTO_LENGTH, Closure::Trampoline, closure, &result);
+    if (status == napi_ok) {
+        status = napi_add_finalizer(env, result, closure, Closure::Finalize, nullptr, nullptr);
+    }
+    if (status != napi_ok) {
+        Closure::Delete(closure);
+        NAPI_CHECK_STATUS(env, status, "Failed to create function");
+    }
+    return Function(env, result);
+}
+
+template <typename Callable, typename>
+inline Function Function::Create(napi_env env, const std::string &utf8name, Callable &&callable) {
+    return Create(env, utf8name.c_str(), std::forward<Callable>(callable));
+}
+
 inline Value Function::call(Value recv, const std::initializer_list<Value> &args) const {
     napi_value result;
     napi_value argv[args.size()];
@@ -532,6 +1582,89 @@ inline Value Function::call(const std::initializer_list<napi_value> &args) const
     return Value(env_, result);
 }
 
+template <typename... Args> inline Value Function::operator()(const Args &...args) const {
+    napi_value argv[sizeof...(Args) > 0 ? sizeof...(Args) : 1] = {Converter<Args>::ToJS(env_, args)...};
+    napi_value result;
+    NAPI_CHECK_STATUS(env_, napi_call_function(env_, details::Undefined(env_), value_, sizeof...(Args), argv, &result),
+                      "napi_call_function failed");
+    return Value(env_, result);
+}
+
+namespace details {
+// callEach的参数打包：std::tuple展开为多个参数，其他类型为单个参数
+template <typename T> struct ArgPack {
+    static constexpr std::size_t kCount = 1;
+    static void Fill(napi_env env, const T &value, napi_value *argv) { argv[0] = Converter<T>::ToJS(env, value); }
+};
+
+template <typename... Ts> struct ArgPack<std::tuple<Ts...>> {
+    static constexpr std::size_t kCount = sizeof...(Ts);
+    static void Fill(napi_env env, const std::tuple<Ts...> &value, napi_value *argv) {
+        Fill(env, value, argv, std::index_sequence_for<Ts...>());
+    }
+
+private:
+    template <std::size_t... I>
+    static void Fill(napi_env env, const std::tuple<Ts...> &value, napi_value *argv, std::index_sequence<I...>) {
+        ((argv[I] = Converter<std::tuple_element_t<I, std::tuple<Ts...>>>::ToJS(env, std::get<I>(value))), ...);
+    }
+};
+} // namespace details
+
+template <typename Range, typename Mapper>
+inline std::size_t Function::callEach(const Range &range, Mapper mapper, const CallEachOptions &options) const {
+    using Item = decltype(*std::begin(range));
+    using Mapped = std::decay_t<std::invoke_result_t<Mapper &, Item>>;
+    using Pack = details::ArgPack<Mapped>;
+    std::size_t chunkSize = std::max<std::size_t>(options.chunkSize, 1);
+    napi_value argv[Pack::kCount > 0 ? Pack::kCount : 1];
+    std::optional<tools::HandleScope> scope;
+    std::size_t count = 0;
+    for (auto it = std::begin(range), end = std::end(range); it != end; ++it) {
+        if (count % chunkSize == 0) {
+            scope.reset();
+            scope.emplace(env_);
+        }
+        Pack::Fill(env_, mapper(*it), argv);
+        napi_value result;
+        NAPI_CHECK_STATUS(env_, napi_call_function(env_, details::Undefined(env_), value_, Pack::kCount, argv, &result),
+                          "napi_call_function failed");
+        ++count;
+        if (options.stopOnFalse && details::TypeOf(env_, result) == napi_boolean && !Converter<bool>::FromJS(env_, result)) {
+            break;
+        }
+    }
+    return count;
+}
+
+template <typename Range, typename Mapper> inline Value Function::callCoalesced(const Range &range, Mapper mapper) const {
+    using Item = decltype(*std::begin(range));
+    using Mapped = std::decay_t<std::invoke_result_t<Mapper &, Item>>;
+    std::size_t length = static_cast<std::size_t>(std::distance(std::begin(range), std::end(range)));
+    napi_value packed;
+    if constexpr (std::is_arithmetic<Mapped>::value && details::HasTypedArray<Mapped>::value) {
+        auto array = TypedArrayOf<Mapped>::Create(env_, length);
+        Mapped *data = array.data();
+        for (const auto &item : range) {
+            *data++ = mapper(item);
+        }
+        packed = array;
+    } else {
+        packed = Array::Create(env_, length);
+        std::uint32_t index = 0;
+        std::optional<tools::HandleScope> scope;
+        for (const auto &item : range) {
+            if (index % 256 == 0) {
+                scope.reset();
+                scope.emplace(env_);
+            }
+            NAPI_CHECK_STATUS(env_, napi_set_element(env_, packed, index++, Converter<Mapped>::ToJS(env_, mapper(item))),
+                              "napi_set_element failed");
+        }
+    }
+    return (*this)(packed);
+}
+
 /* ---------------------------------- Array --------------------------------- */
 
 inline Array Array::Create(napi_env env) {
@@ -552,42 +1685,689 @@ inline std::uint32_t Array::length() const {
     return result;
 }
 
+/* ------------------------------- ArrayBuffer ------------------------------ */
+
+namespace details {
+// 外部内存的finalizer上下文，作为napi_finalize的hint传递
+template <typename Finalizer, typename Hint = void> struct ExternalFinalizeData {
+    static void Wrapper(napi_env, void *data, void *hint) {
+        auto *finalizeData = static_cast<ExternalFinalizeData *>(hint);
+        finalizeData->accounted.reset();
+        finalizeData->data = data;
+        if constexpr (tools::FinalizeOnJSThread<Finalizer>::value) {
+            Finish(finalizeData);
+        } else {
+            tools::Reclaimer::Instance().retire(finalizeData, Finish);
+        }
+    }
+
+    static void Finish(void *ptr) {
+        auto *finalizeData = static_cast<ExternalFinalizeData *>(ptr);
+        finalizeData->Invoke(finalizeData->data);
+        delete finalizeData;
+    }
+
+    template <typename H = Hint> typename std::enable_if<std::is_void<H>::value>::type Invoke(void *data) {
+        callback(data);
+    }
+    template <typename H = Hint> typename std::enable_if<!std::is_void<H>::value>::type Invoke(void *data) {
+        callback(data, hint);
+    }
+
+    Finalizer callback;
+    Hint *hint;
+    tools::Accounted accounted;
+    void *data = nullptr;
+};
+
+// onFailure只在创建失败时调用；创建成功后finalizeData归ArrayBuffer所有，之后抛出的异常不再回滚
+template <typename FinalizeData>
+inline ArrayBuffer CreateExternalArrayBuffer(napi_env env, void *data, std::size_t byteLength,
+                                             FinalizeData *finalizeData,
+                                             const std::function<void()> &onFailure = nullptr) {
+    napi_value value;
+    napi_status status = napi_create_external_arraybuffer(env, data, byteLength, FinalizeData::Wrapper,
+                                                          finalizeData, &value);
+    if (status != napi_ok) {
+        delete finalizeData;
+        if (onFailure) {
+            onFailure();
+        }
+        NAPI_CHECK_STATUS(env, status, "napi_create_external_arraybuffer failed");
+    }
+    finalizeData->accounted = tools::Accounted(env, tools::MemoryAccounting::kArrayBuffer, byteLength);
+    return ArrayBuffer(env, value);
+}
+} // namespace details
+
+inline ArrayBuffer ArrayBuffer::Create(napi_env env, std::size_t byteLength) {
+    napi_value value;
+    void *data;
+    NAPI_CHECK_STATUS(env, napi_create_arraybuffer(env, byteLength, &data, &value), "napi_create_arraybuffer failed");
+    return ArrayBuffer(env, value);
+}
+
+template <typename Finalizer>
+inline ArrayBuffer ArrayBuffer::CreateExternal(napi_env env, void *data, std::size_t byteLength,
+                                               Finalizer finalizer) {
+    using FinalizeData = details::ExternalFinalizeData<Finalizer>;
+    return details::CreateExternalArrayBuffer(env, data, byteLength,
+                                              new FinalizeData{std::move(finalizer), nullptr, {}});
+}
+
+template <typename Finalizer, typename Hint>
+inline ArrayBuffer ArrayBuffer::CreateExternal(napi_env env, void *data, std::size_t byteLength, Finalizer finalizer,
+                                               Hint *hint) {
+    using FinalizeData = details::ExternalFinalizeData<Finalizer, Hint>;
+    return details::CreateExternalArrayBuffer(env, data, byteLength,
+                                              new FinalizeData{std::move(finalizer), hint, {}});
+}
+
+inline ArrayBuffer ArrayBuffer::CreateExternal(napi_env env, tools::PooledBuffer &&buffer) {
+    auto finalizer = [](void *, tools::PooledBuffer *hint) { delete hint; };
+    using FinalizeData = details::ExternalFinalizeData<decltype(finalizer), tools::PooledBuffer>;
+    auto *holder = new tools::PooledBuffer(std::move(buffer));
+    // 只有创建失败时缓冲区才归还给调用方
+    return details::CreateExternalArrayBuffer(env, holder->data(), holder->size(),
+                                              new FinalizeData{finalizer, holder, {}}, [&buffer, holder] {
+                                                  buffer = std::move(*holder);
+                                                  delete holder;
+                                              });
+}
+
+inline void *ArrayBuffer::data() const {
+    void *data;
+    NAPI_CHECK_STATUS(env_, napi_get_arraybuffer_info(env_, value_, &data, nullptr), "napi_get_arraybuffer_info failed");
+    return data;
+}
+
+inline std::size_t ArrayBuffer::byteLength() const {
+    std::size_t length;
+    NAPI_CHECK_STATUS(env_, napi_get_arraybuffer_info(env_, value_, nullptr, &length),
+                      "napi_get_arraybuffer_info failed");
+    return length;
+}
+
+/* ------------------------------- TypedArray ------------------------------- */
+
+inline napi_typedarray_type TypedArray::typedArrayType() const {
+    napi_typedarray_type type;
+    NAPI_CHECK_STATUS(env_, napi_get_typedarray_info(env_, value_, &type, nullptr, nullptr, nullptr, nullptr),
+                      "napi_get_typedarray_info failed");
+    return type;
+}
+
+inline std::size_t TypedArray::elementLength() const {
+    std::size_t length;
+    NAPI_CHECK_STATUS(env_, napi_get_typedarray_info(env_, value_, nullptr, &length, nullptr, nullptr, nullptr),
+                      "napi_get_typedarray_info failed");
+    return length;
+}
+
+inline std::size_t TypedArray::byteOffset() const {
+    std::size_t offset;
+    NAPI_CHECK_STATUS(env_, napi_get_typedarray_info(env_, value_, nullptr, nullptr, nullptr, nullptr, &offset),
+                      "napi_get_typedarray_info failed");
+    return offset;
+}
+
+inline ArrayBuffer TypedArray::arrayBuffer() const {
+    napi_value buffer;
+    NAPI_CHECK_STATUS(env_, napi_get_typedarray_info(env_, value_, nullptr, nullptr, nullptr, &buffer, nullptr),
+                      "napi_get_typedarray_info failed");
+    return ArrayBuffer(env_, buffer);
+}
+
+template <typename T> inline TypedArrayOf<T> TypedArrayOf<T>::Create(napi_env env, std::size_t length) {
+    return Create(env, length, ArrayBuffer::Create(env, length * sizeof(T)), 0);
+}
+
+template <typename T>
+inline TypedArrayOf<T> TypedArrayOf<T>::Create(napi_env env, std::size_t length, const ArrayBuffer &buffer,
+                                               std::size_t byteOffset) {
+    napi_value value;
+    NAPI_CHECK_STATUS(env, napi_create_typedarray(env, kType, length, buffer, byteOffset, &value),
+                      "napi_create_typedarray failed");
+    return TypedArrayOf<T>(env, value);
+}
+
+template <typename T> inline TypedArrayOf<T> TypedArrayOf<T>::Create(napi_env env, const T *data, std::size_t length) {
+    TypedArrayOf<T> result = Create(env, length);
+    if (length != 0) {
+        std::memcpy(result.data(), data, length * sizeof(T));
+    }
+    return result;
+}
+
+template <typename T> inline std::vector<T> TypedArrayOf<T>::toVector() const {
+    std::size_t count;
+    void *raw;
+    NAPI_CHECK_STATUS(env_, napi_get_typedarray_info(env_, value_, nullptr, &count, &raw, nullptr, nullptr),
+                      "napi_get_typedarray_info failed");
+    const T *begin = static_cast<const T *>(raw);
+    return std::vector<T>(begin, begin + count);
+}
+
+template <typename T> inline T *TypedArrayOf<T>::data() const {
+    void *data;
+    NAPI_CHECK_STATUS(env_, napi_get_typedarray_info(env_, value_, nullptr, nullptr, &data, nullptr, nullptr),
+                      "napi_get_typedarray_info failed");
+    return static_cast<T *>(data);
+}
+
+/* -------------------------------- DataView -------------------------------- */
+
+inline DataView DataView::Create(napi_env env, const ArrayBuffer &buffer, std::size_t byteOffset,
+                                 std::size_t byteLength) {
+    napi_value value;
+    NAPI_CHECK_STATUS(env, napi_create_dataview(env, byteLength, buffer, byteOffset, &value),
+                      "napi_create_dataview failed");
+    return DataView(env, value);
+}
+
+inline std::size_t DataView::byteLength() const {
+    std::size_t result;
+    NAPI_CHECK_STATUS(env_, napi_get_dataview_info(env_, value_, &result, nullptr, nullptr, nullptr),
+                      "napi_get_dataview_info failed");
+    return result;
+}
+
+inline std::size_t DataView::byteOffset() const {
+    std::size_t result;
+    NAPI_CHECK_STATUS(env_, napi_get_dataview_info(env_, value_, nullptr, nullptr, nullptr, &result),
+                      "napi_get_dataview_info failed");
+    return result;
+}
+
+inline ArrayBuffer DataView::arrayBuffer() const {
+    napi_value buffer;
+    NAPI_CHECK_STATUS(env_, napi_get_dataview_info(env_, value_, nullptr, nullptr, &buffer, nullptr),
+                      "napi_get_dataview_info failed");
+    return ArrayBuffer(env_, buffer);
+}
+
+inline std::uint8_t *DataView::data() const {
+    void *data;
+    NAPI_CHECK_STATUS(env_, napi_get_dataview_info(env_, value_, nullptr, &data, nullptr, nullptr),
+                      "napi_get_dataview_info failed");
+    return static_cast<std::uint8_t *>(data);
+}
+
+/* ----------------------------- ObjectTemplate ----------------------------- */
+
+inline ObjectTemplate::ObjectTemplate(std::initializer_list<const char *> names)
+    : ObjectTemplate(std::vector<std::string>(names.begin(), names.end())) {}
+
+inline ObjectTemplate::ObjectTemplate(std::vector<std::string> names) : names_(std::move(names)) {
+    keys_.reserve(names_.size());
+    for (const auto &name : names_) {
+        keys_.push_back(name.c_str());
+    }
+}
+
+inline Object ObjectTemplate::createFrom(napi_env env, const napi_value *values) const {
+    napi_value result;
+#if defined(NAPI_FRAMEWORK_PORTABLE)
+    tools::ArenaVector<napi_property_descriptor> descriptors(keys_.size());
+    for (std::size_t i = 0; i < keys_.size(); ++i) {
+        descriptors[i] = {keys_[i], nullptr, nullptr, nullptr, nullptr, values[i],
+                          static_cast<napi_property_attributes>(napi_writable | napi_enumerable | napi_configurable),
+                          nullptr};
+    }
+    NAPI_CHECK_STATUS(env, napi_create_object(env, &result), "Create object failed");
+    NAPI_CHECK_STATUS(env, napi_define_properties(env, result, descriptors.size(), descriptors.data()),
+                      "napi_define_properties failed");
+#else
+    NAPI_CHECK_STATUS(env,
+                      napi_create_object_with_named_properties(env, &result, keys_.size(),
+                                                               const_cast<const char **>(keys_.data()), values),
+                      "napi_create_object_with_named_properties failed");
+#endif
+    return Object(env, result);
+}
+
+template <typename... Ts> inline Object ObjectTemplate::create(napi_env env, const Ts &...values) const {
+    if (sizeof...(Ts) != keys_.size()) {
+        throw std::runtime_error("ObjectTemplate: value count mismatch");
+    }
+    napi_value argv[sizeof...(Ts) > 0 ? sizeof...(Ts) : 1] = {Value::From(env, values)...};
+    return createFrom(env, argv);
+}
+
+template <typename Filler>
+inline Array ObjectTemplate::createArray(napi_env env, std::size_t count, Filler filler) const {
+    constexpr std::size_t kBatch = 256;
+    Array result = Array::Create(env, count);
+    tools::ArenaVector<napi_value> values(keys_.size());
+    for (std::size_t begin = 0; begin < count; begin += kBatch) {
+        tools::HandleScope scope(env);
+        std::size_t end = begin + kBatch < count ? begin + kBatch : count;
+        for (std::size_t i = begin; i < end; ++i) {
+            filler(i, values.data());
+            Object object = createFrom(env, values.data());
+            NAPI_CHECK_STATUS(env, napi_set_element(env, result, static_cast<std::uint32_t>(i), object),
+                              "napi_set_element failed");
+        }
+    }
+    return result;
+}
+
+/* ---------------------------- MemoryAccounting ---------------------------- */
+
+namespace tools {
+inline void MemoryAccounting::add(napi_env env, const char *category, std::size_t byteLength) {
+    std::int64_t adjusted;
+    NAPI_CHECK_STATUS(env, napi_adjust_external_memory(env, static_cast<std::int64_t>(byteLength), &adjusted),
+                      "napi_adjust_external_memory failed");
+    std::lock_guard<std::mutex> lck(mtx_);
+    auto it = categories_.find(std::string_view(category));
+    if (it == categories_.end()) {
+        it = categories_.emplace(category, Usage()).first;
+    }
+    it->second.bytes += static_cast<std::int64_t>(byteLength);
+    it->second.count += 1;
+    total_.bytes += static_cast<std::int64_t>(byteLength);
+    total_.count += 1;
+}
+
+inline void MemoryAccounting::remove(napi_env env, const char *category, std::size_t byteLength) {
+    // 通常在finalizer中调用，不抛异常
+    std::int64_t adjusted;
+    napi_adjust_external_memory(env, -static_cast<std::int64_t>(byteLength), &adjusted);
+    std::lock_guard<std::mutex> lck(mtx_);
+    auto it = categories_.find(std::string_view(category));
+    if (it != categories_.end()) {
+        it->second.bytes -= static_cast<std::int64_t>(byteLength);
+        it->second.count -= 1;
+    }
+    total_.bytes -= static_cast<std::int64_t>(byteLength);
+    total_.count -= 1;
+}
+
+inline MemoryAccounting::Usage MemoryAccounting::usage(std::string_view category) const {
+    std::lock_guard<std::mutex> lck(mtx_);
+    auto it = categories_.find(category);
+    return it != categories_.end() ? it->second : Usage();
+}
+
+inline MemoryAccounting::Usage MemoryAccounting::total() const {
+    std::lock_guard<std::mutex> lck(mtx_);
+    return total_;
+}
+
+inline std::map<std::string, MemoryAccounting::Usage, std::less<>> MemoryAccounting::snapshot() const {
+    std::lock_guard<std::mutex> lck(mtx_);
+    return categories_;
+}
+
+inline Accounted::Accounted(napi_env env, const char *category, std::size_t byteLength)
+    : env_(env), category_(category), byteLength_(byteLength) {
+    MemoryAccounting::Instance().add(env_, category_, byteLength_);
+}
+
+inline Accounted::Accounted(Accounted &&other) noexcept
+    : env_(other.env_), category_(other.category_), byteLength_(other.byteLength_) {
+    other.category_ = nullptr;
+}
+
+inline Accounted &Accounted::operator=(Accounted &&other) noexcept {
+    if (this != &other) {
+        reset();
+        env_ = other.env_;
+        category_ = other.category_;
+        byteLength_ = other.byteLength_;
+        other.category_ = nullptr;
+    }
+    return *this;
+}
+
+inline void Accounted::resize(std::size_t byteLength) {
+    if (category_ == nullptr || byteLength == byteLength_) {
+        return;
+    }
+    // 先记入新的大小再扣除旧的，记入失败时保持原状
+    MemoryAccounting::Instance().add(env_, category_, byteLength);
+    MemoryAccounting::Instance().remove(env_, category_, byteLength_);
+    byteLength_ = byteLength;
+}
+
+inline void Accounted::reset() {
+    if (category_ != nullptr) {
+        MemoryAccounting::Instance().remove(env_, category_, byteLength_);
+        category_ = nullptr;
+    }
+}
+} // namespace tools
+
+/* -------------------------------- Reclaimer ------------------------------- */
+
+namespace tools {
+inline Reclaimer::~Reclaimer() {
+    {
+        std::lock_guard<std::mutex> lck(mtx_);
+        stop_ = true;
+    }
+    wakeup_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+inline void Reclaimer::retire(void *ptr, Deleter deleter) {
+    {
+        std::lock_guard<std::mutex> lck(mtx_);
+        if (stop_) {
+            deleter(ptr);
+            return;
+        }
+        if (!thread_.joinable()) {
+            thread_ = std::thread([this] { run(); });
+        }
+        queue_.push_back(Item{ptr, deleter});
+    }
+    wakeup_.notify_one();
+}
+
+template <typename T> inline void Reclaimer::retire(T *ptr) {
+    if constexpr (FinalizeOnJSThread<T>::value) {
+        delete ptr;
+    } else {
+        retire(ptr, [](void *p) { delete static_cast<T *>(p); });
+    }
+}
+
+inline void Reclaimer::flush() {
+    std::unique_lock<std::mutex> lck(mtx_);
+    idle_.wait(lck, [this] { return queue_.empty() && inFlight_ == 0; });
+}
+
+inline std::size_t Reclaimer::pending() const {
+    std::lock_guard<std::mutex> lck(mtx_);
+    return queue_.size() + inFlight_;
+}
+
+inline void Reclaimer::run() {
+    std::vector<Item> batch;
+    std::unique_lock<std::mutex> lck(mtx_);
+    for (;;) {
+        wakeup_.wait(lck, [this] { return stop_ || !queue_.empty(); });
+        if (queue_.empty() && stop_) {
+            return;
+        }
+        // 一次取走整个队列，析构期间不持锁
+        batch.swap(queue_);
+        inFlight_ = batch.size();
+        lck.unlock();
+        for (const Item &item : batch) {
+            item.deleter(item.ptr);
+        }
+        batch.clear();
+        lck.lock();
+        inFlight_ = 0;
+        if (queue_.empty()) {
+            idle_.notify_all();
+        }
+    }
+}
+
+inline void Reclaimer::retireReference(napi_env env, napi_ref ref) {
+    bool schedule;
+    {
+        std::lock_guard<std::mutex> lck(refMtx_);
+        auto &refs = refs_[env];
+        schedule = refs.empty();
+        refs.push_back(ref);
+    }
+    pendingRefs_.fetch_add(1, std::memory_order_release);
+#ifndef NAPI_FRAMEWORK_PORTABLE
+    if (schedule) {
+        napi_send_event(env, [env] { Reclaimer::Instance().drainReferences(env); }, napi_eprio_idle);
+    }
+#else
+    (void)schedule;
+#endif
+}
+
+inline void Reclaimer::drainReferences(napi_env env) {
+#ifdef NAPI_FRAMEWORK_PORTABLE
+    watchEnv(env);
+#endif
+    deleteReferences(env);
+}
+
+#ifdef NAPI_FRAMEWORK_PORTABLE
+inline napi_env &Reclaimer::WatchedEnv() {
+    static thread_local napi_env env = nullptr;
+    return env;
+}
+
+inline void Reclaimer::watchEnv(napi_env env) {
+    napi_env &watched = WatchedEnv();
+    if (watched == env) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lck(refMtx_);
+        if (watched_.insert(env).second && napi_add_env_cleanup_hook(env, OnEnvCleanup, env) != napi_ok) {
+            watched_.erase(env);
+            return;
+        }
+    }
+    watched = env;
+}
+
+inline void Reclaimer::OnEnvCleanup(void *arg) {
+    auto env = static_cast<napi_env>(arg);
+    Reclaimer &self = Instance();
+    {
+        std::lock_guard<std::mutex> lck(self.refMtx_);
+        self.watched_.erase(env);
+    }
+    // 清理钩子在env的JS线程上执行，地址可能被之后创建的env复用
+    if (WatchedEnv() == env) {
+        WatchedEnv() = nullptr;
+    }
+    self.deleteReferences(env);
+}
+#endif
+
+inline void Reclaimer::deleteReferences(napi_env env) {
+    if (pendingRefs_.load(std::memory_order_acquire) == 0) {
+        return;
+    }
+    std::vector<napi_ref> refs;
+    {
+        std::lock_guard<std::mutex> lck(refMtx_);
+        auto it = refs_.find(env);
+        if (it == refs_.end()) {
+            return;
+        }
+        refs.swap(it->second);
+        refs_.erase(it);
+    }
+    pendingRefs_.fetch_sub(refs.size(), std::memory_order_acq_rel);
+    for (napi_ref ref : refs) {
+        napi_delete_reference(env, ref);
+    }
+}
+} // namespace tools
+
+/* ------------------------------- BufferPool ------------------------------- */
+
+namespace tools {
+
+struct BufferPool::State {
+    void recycle(void *data, std::size_t capacity) {
+        {
+            std::lock_guard<std::mutex> lck(mtx);
+            if (alive) {
+                auto &freeList = freeLists[capacity];
+                if (freeList.size() < maxCachedPerClass) {
+                    freeList.push_back(data);
+                    cachedBytes += capacity;
+                    return;
+                }
+            }
+        }
+        ::operator delete(data);
+    }
+
+    void clear() {
+        for (auto &[capacity, freeList] : freeLists) {
+            for (void *data : freeList) {
+                ::operator delete(data);
+            }
+        }
+        freeLists.clear();
+        cachedBytes = 0;
+    }
+
+    std::mutex mtx;
+    bool alive = true;
+    std::size_t maxCachedPerClass;
+    std::size_t minBlockSize;
+    std::size_t cachedBytes = 0;
+    std::map<std::size_t, std::vector<void *>> freeLists; // 尺寸级别 -> 空闲缓冲区
+};
+
+inline BufferPool::BufferPool(std::size_t maxCachedPerClass, std::size_t minBlockSize)
+    : state_(std::make_shared<State>()) {
+    if (minBlockSize < 4 || (minBlockSize & (minBlockSize - 1)) != 0) {
+        throw std::invalid_argument("BufferPool minBlockSize must be a power of two no less than 4");
+    }
+    state_->maxCachedPerClass = maxCachedPerClass;
+    state_->minBlockSize = minBlockSize;
+}
+
+inline BufferPool::~BufferPool() {
+    std::lock_guard<std::mutex> lck(state_->mtx);
+    state_->alive = false;
+    state_->clear();
+}
+
+inline std::size_t BufferPool::sizeClassOf(std::size_t size, std::size_t minBlockSize) {
+    if (minBlockSize < 4 || (minBlockSize & (minBlockSize - 1)) != 0) {
+        throw std::invalid_argument("BufferPool minBlockSize must be a power of two no less than 4");
+    }
+    if (size <= minBlockSize) {
+        return minBlockSize;
+    }
+    // 最大的级别为size_t能表示的最大2的幂次，再大的upper会溢出
+    constexpr std::size_t kLargestClass = (std::numeric_limits<std::size_t>::max() >> 1) + 1;
+    if (size > kLargestClass) {
+        throw std::length_error("BufferPool buffer size too large");
+    }
+    // 找到不小于size的最小 2^k，再在[2^(k-1), 2^k]之间四等分取级别
+    std::size_t upper = minBlockSize;
+    while (upper < size) {
+        upper <<= 1;
+    }
+    std::size_t step = (upper >> 1) / 4;
+    std::size_t capacity = upper >> 1;
+    while (capacity < size) {
+        capacity += step;
+    }
+    return capacity;
+}
+
+inline PooledBuffer BufferPool::acquire(std::size_t size) {
+    std::size_t capacity = sizeClassOf(size, state_->minBlockSize);
+    {
+        std::lock_guard<std::mutex> lck(state_->mtx);
+        auto it = state_->freeLists.find(capacity);
+        if (it != state_->freeLists.end() && !it->second.empty()) {
+            void *data = it->second.back();
+            it->second.pop_back();
+            state_->cachedBytes -= capacity;
+            return PooledBuffer(state_, data, size, capacity);
+        }
+    }
+    return PooledBuffer(state_, ::operator new(capacity), size, capacity);
+}
+
+inline std::size_t BufferPool::cachedBytes() const {
+    std::lock_guard<std::mutex> lck(state_->mtx);
+    return state_->cachedBytes;
+}
+
+inline void BufferPool::trim() {
+    std::lock_guard<std::mutex> lck(state_->mtx);
+    state_->clear();
+}
+
+inline PooledBuffer::PooledBuffer(PooledBuffer &&other) noexcept
+    : state_(std::move(other.state_)), data_(std::exchange(other.data_, nullptr)),
+      size_(std::exchange(other.size_, 0)), capacity_(std::exchange(other.capacity_, 0)) {}
+
+inline PooledBuffer &PooledBuffer::operator=(PooledBuffer &&other) noexcept {
+    if (this != &other) {
+        reset();
+        state_ = std::move(other.state_);
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+        capacity_ = std::exchange(other.capacity_, 0);
+    }
+    return *this;
+}
+
+inline void PooledBuffer::reset() {
+    if (data_ != nullptr) {
+        state_->recycle(data_, capacity_);
+        data_ = nullptr;
+        size_ = 0;
+        capacity_ = 0;
+    }
+    state_.reset();
+}
+
+} // namespace tools
+
 /* -------------------------------- Reference ------------------------------- */
 
 namespace tools {
 
 template <typename T> inline Reference<T> Reference<T>::Create(const T &value, std::uint32_t initial) {
     napi_env env = value.env();
+    // 顺带删除其他线程释放后排队等待的napi_ref
+    Reclaimer::Instance().drainReferences(env);
     napi_ref ref;
     NAPI_CHECK_STATUS(env, napi_create_reference(env, value, initial, &ref), "napi_create_reference failed");
     return Reference<T>(env, ref);
 }
 
-template <typename T> inline Reference<T>::Reference(napi_env env, napi_ref ref) : env_(env), ref_(ref) {}
+template <typename T>
+inline Reference<T>::Reference(napi_env env, napi_ref ref) : env_(env), ref_(ref), owner_(std::this_thread::get_id()) {}
 
 template <typename T> inline Reference<T>::~Reference() {
     // 这里是否要判断引用计数，否则是否可能发生delete了外部传入的napi_ref，而外部也delete了这个ref而导致该对象double free的问题
     // 不，直接要求外部传入的ref会直接被当前类获得所有权。这样和其他的类的风格统一了
-    if (ref_ != nullptr) {
+    if (ref_ == nullptr) {
+        return;
+    }
+    if (std::this_thread::get_id() == owner_) {
         napi_delete_reference(env_, ref_);
+    } else {
+        Reclaimer::Instance().retireReference(env_, ref_);
     }
     ref_ = nullptr;
 }
 
 template <typename T>
 inline Reference<T>::Reference(Reference<T> &&other)
-    : env_(std::exchange(other.env_, nullptr)), ref_(std::exchange(other.ref_, nullptr)) {}
+    : env_(std::exchange(other.env_, nullptr)), ref_(std::exchange(other.ref_, nullptr)), owner_(other.owner_) {}
 
 template <typename T> inline Reference<T> &Reference<T>::operator=(Reference<T> &&other) {
     if (this != &other) {
         reset();
         env_ = std::exchange(other.env_, nullptr);
         ref_ = std::exchange(other.ref_, nullptr);
+        owner_ = other.owner_;
     }
     return *this;
 }
 
-template <typename T> inline Reference<T>::Reference(const Reference<T> &other) : env_(other.env_), ref_(nullptr) {
+template <typename T> inline Reference<T>::Reference(const Reference<T> &other)
+    : env_(other.env_), ref_(nullptr), owner_(std::this_thread::get_id()) {
     HandleScope scope(env_);
 
     napi_value value = other.value();
@@ -621,15 +2401,21 @@ template <typename T> inline std::uint32_t Reference<T>::unref() const {
 }
 
 template <typename T> inline void Reference<T>::reset() {
-    if (ref_ != nullptr) {
+    if (ref_ == nullptr) {
+        return;
+    }
+    if (std::this_thread::get_id() == owner_) {
         NAPI_CHECK_STATUS(env_, napi_delete_reference(env_, ref_), "napi_delete_reference failed");
-        ref_ = nullptr;
+    } else {
+        Reclaimer::Instance().retireReference(env_, ref_);
     }
+    ref_ = nullptr;
 }
 
 template <typename T> inline void Reference<T>::reset(const T &value, uint32_t refcount) {
     reset();
     env_ = value.env();
+    owner_ = std::this_thread::get_id();
 
     napi_value val = value;
     if (val != nullptr) {
@@ -647,6 +2433,276 @@ template <typename T> inline T Reference<T>::value() const {
     return T(env_, value);
 }
 
+template <typename T>
+inline UniqueReference<T> UniqueReference<T>::Create(const T &value, std::uint32_t initial) {
+    napi_env env = value.env();
+    Reclaimer::Instance().drainReferences(env);
+    napi_ref ref;
+    NAPI_CHECK_STATUS(env, napi_create_reference(env, value, initial, &ref), "napi_create_reference failed");
+    return UniqueReference<T>(env, ref);
+}
+
+template <typename T> inline UniqueReference<T> &UniqueReference<T>::operator=(UniqueReference<T> &&other) {
+    if (this != &other) {
+        this->reset();
+        this->env_ = std::exchange(other.env_, nullptr);
+        this->ref_ = std::exchange(other.ref_, nullptr);
+        this->owner_ = other.owner_;
+    }
+    return *this;
+}
+
+/* ----------------------------- ReferenceTable ----------------------------- */
+
+inline ReferenceTable::~ReferenceTable() {
+    for (Slot &slot : slots_) {
+        if (slot.weak == nullptr) {
+            continue;
+        }
+        if (std::this_thread::get_id() == owner_) {
+            napi_delete_reference(env_, slot.weak);
+        } else {
+            Reclaimer::Instance().retireReference(env_, slot.weak);
+        }
+    }
+    // values_随后析构，释放全部强引用
+}
+
+inline ReferenceTable::Handle ReferenceTable::add(const Value &value) {
+    napi_value array = values();
+    std::uint32_t index = allocate();
+    napi_status status = napi_set_element(env_, array, index, value);
+    if (status != napi_ok) {
+        releaseSlot(index, nullptr);
+        NAPI_CHECK_STATUS(env_, status, "napi_set_element failed");
+    }
+    return MakeHandle(index, slots_[index].generation);
+}
+
+inline void ReferenceTable::add(const napi_value *values, std::size_t count, Handle *handles) {
+    constexpr std::size_t kMaxPushArgs = 8192;
+    napi_value array = this->values();
+    std::size_t i = 0;
+    // 先填补空闲槽位
+    for (; i < count && freeHead_ != kNoSlot; ++i) {
+        std::uint32_t index = allocate();
+        napi_status status = napi_set_element(env_, array, index, values[i]);
+        if (status != napi_ok) {
+            releaseSlot(index, nullptr);
+            NAPI_CHECK_STATUS(env_, status, "napi_set_element failed");
+        }
+        handles[i] = MakeHandle(index, slots_[index].generation);
+    }
+    if (i == count) {
+        return;
+    }
+    // 数组长度不超过槽位数；弱引用槽位不写入数组，长度可能不足，先在末尾槽位写入undefined补齐，
+    // 其余的值push到数组末尾即落在新槽位的下标上
+    std::uint32_t length = 0;
+    NAPI_CHECK_STATUS(env_, napi_get_array_length(env_, array, &length), "napi_get_array_length failed");
+    if (length < slots_.size()) {
+        NAPI_CHECK_STATUS(env_,
+                          napi_set_element(env_, array, static_cast<std::uint32_t>(slots_.size() - 1),
+                                           Env(env_).undefined()),
+                          "napi_set_element failed");
+    }
+    napi_value push;
+    NAPI_CHECK_STATUS(env_, napi_get_named_property(env_, array, "push", &push), "napi_get_named_property failed");
+    while (i < count) {
+        std::size_t batch = std::min(count - i, kMaxPushArgs);
+        if (slots_.size() + batch >= kUsed) {
+            throw std::length_error("ReferenceTable is full");
+        }
+        napi_value newLength;
+        NAPI_CHECK_STATUS(env_, napi_call_function(env_, array, push, batch, values + i, &newLength),
+                          "Array.prototype.push failed");
+        for (std::size_t end = i + batch; i < end; ++i) {
+            std::uint32_t index = allocate();
+            handles[i] = MakeHandle(index, slots_[index].generation);
+        }
+    }
+}
+
+inline ReferenceTable::Handle ReferenceTable::addWeak(const Value &value) {
+    Reclaimer::Instance().drainReferences(env_);
+    napi_ref ref;
+    NAPI_CHECK_STATUS(env_, napi_create_reference(env_, value, 0, &ref), "napi_create_reference failed");
+    std::uint32_t index = allocate();
+    slots_[index].weak = ref;
+    return MakeHandle(index, slots_[index].generation);
+}
+
+inline Value ReferenceTable::get(Handle handle) const {
+    const Slot *slot = find(handle);
+    if (slot == nullptr) {
+        return Value(env_);
+    }
+    napi_value result;
+    if (slot->weak != nullptr) {
+        NAPI_CHECK_STATUS(env_, napi_get_reference_value(env_, slot->weak, &result), "napi_get_reference_value failed");
+    } else {
+        NAPI_CHECK_STATUS(env_, napi_get_element(env_, values(), static_cast<std::uint32_t>(handle), &result),
+                          "napi_get_element failed");
+    }
+    return Value(env_, result);
+}
+
+inline bool ReferenceTable::contains(Handle handle) const { return find(handle) != nullptr; }
+
+inline void ReferenceTable::release(Handle handle) {
+    const Slot *slot = find(handle);
+    if (slot != nullptr) {
+        releaseSlot(static_cast<std::uint32_t>(handle), slot->weak == nullptr ? values() : nullptr);
+    }
+}
+
+template <typename It> inline void ReferenceTable::release(It first, It last) {
+    napi_value array = nullptr;
+    for (; first != last; ++first) {
+        Handle handle = *first;
+        const Slot *slot = find(handle);
+        if (slot == nullptr) {
+            continue;
+        }
+        if (slot->weak == nullptr && array == nullptr) {
+            array = values();
+        }
+        releaseSlot(static_cast<std::uint32_t>(handle), slot->weak == nullptr ? array : nullptr);
+    }
+}
+
+inline void ReferenceTable::clear() {
+    for (Slot &slot : slots_) {
+        if (slot.weak != nullptr) {
+            napi_delete_reference(env_, slot.weak);
+        }
+    }
+    // 直接丢弃整个数组，不逐个清除元素
+    values_.reset();
+    slots_.clear();
+    freeHead_ = kNoSlot;
+    size_ = 0;
+}
+
+inline const ReferenceTable::Slot *ReferenceTable::find(Handle handle) const {
+    auto index = static_cast<std::uint32_t>(handle);
+    auto generation = static_cast<std::uint32_t>(handle >> 32);
+    if (index >= slots_.size() || slots_[index].nextFree != kUsed || slots_[index].generation != generation) {
+        return nullptr;
+    }
+    return &slots_[index];
+}
+
+inline std::uint32_t ReferenceTable::allocate() {
+    std::uint32_t index;
+    if (freeHead_ != kNoSlot) {
+        index = freeHead_;
+        freeHead_ = slots_[index].nextFree;
+    } else {
+        if (slots_.size() >= kUsed) {
+            throw std::length_error("ReferenceTable is full");
+        }
+        index = static_cast<std::uint32_t>(slots_.size());
+        slots_.emplace_back();
+    }
+    slots_[index].nextFree = kUsed;
+    ++size_;
+    return index;
+}
+
+inline napi_value ReferenceTable::values() const {
+    if (values_.empty()) {
+        values_ = UniqueReference<Array>::Create(Array::Create(env_), 1);
+    }
+    return values_.value();
+}
+
+inline void ReferenceTable::releaseSlot(std::uint32_t index, napi_value values) {
+    Slot &slot = slots_[index];
+    if (slot.weak != nullptr) {
+        napi_delete_reference(env_, slot.weak);
+        slot.weak = nullptr;
+    } else if (values != nullptr) {
+        napi_set_element(env_, values, index, Env(env_).undefined());
+    }
+    // 代数跳过0，保证任何句柄都不等于kInvalid
+    slot.generation = slot.generation == UINT32_MAX ? 1 : slot.generation + 1;
+    slot.nextFree = freeHead_;
+    freeHead_ = index;
+    --size_;
+}
+
+/* ------------------------------- ObjectCache ------------------------------ */
+
+template <typename Key, typename Hash>
+inline Object ObjectCache<Key, Hash>::find(napi_env env, const Key &key) const {
+    std::lock_guard<std::mutex> lck(state_->mtx);
+    auto it = state_->entries.find(key);
+    if (it == state_->entries.end() || it->second.env != env) {
+        return Object(env, nullptr);
+    }
+    Object object = it->second.ref.value();
+    if (object.isEmpty()) {
+        // 已被GC回收但finalizer还没执行
+        state_->entries.erase(it);
+    }
+    return object;
+}
+
+template <typename Key, typename Hash> inline void ObjectCache<Key, Hash>::insert(const Key &key, const Object &object) {
+    napi_env env = object.env();
+    std::lock_guard<std::mutex> lck(state_->mtx);
+    std::uint64_t token = ++state_->nextToken;
+    auto *hint = new FinalizeHint{state_, key, token};
+    napi_status status = napi_add_finalizer(env, object, nullptr, OnFinalize, hint, nullptr);
+    if (status != napi_ok) {
+        delete hint;
+        NAPI_CHECK_STATUS(env, status, "napi_add_finalizer failed");
+    }
+    state_->entries.erase(key);
+    state_->entries.emplace(key, Entry{env, Reference<Object>::Create(object, 0), token});
+}
+
+template <typename Key, typename Hash>
+template <typename Factory>
+inline Object ObjectCache<Key, Hash>::getOrCreate(napi_env env, const Key &key, Factory factory) {
+    Object cached = find(env, key);
+    if (!cached.isEmpty()) {
+        return cached;
+    }
+    Object created = factory();
+    insert(key, created);
+    return created;
+}
+
+template <typename Key, typename Hash> inline void ObjectCache<Key, Hash>::erase(const Key &key) {
+    std::lock_guard<std::mutex> lck(state_->mtx);
+    state_->entries.erase(key);
+}
+
+template <typename Key, typename Hash> inline void ObjectCache<Key, Hash>::clear() {
+    std::lock_guard<std::mutex> lck(state_->mtx);
+    state_->entries.clear();
+}
+
+template <typename Key, typename Hash> inline std::size_t ObjectCache<Key, Hash>::size() const {
+    std::lock_guard<std::mutex> lck(state_->mtx);
+    return state_->entries.size();
+}
+
+template <typename Key, typename Hash>
+inline void ObjectCache<Key, Hash>::OnFinalize(napi_env env, void *data, void *hint) {
+    auto *finalizeHint = static_cast<FinalizeHint *>(hint);
+    if (auto state = finalizeHint->state.lock()) {
+        std::lock_guard<std::mutex> lck(state->mtx);
+        auto it = state->entries.find(finalizeHint->key);
+        if (it != state->entries.end() && it->second.token == finalizeHint->token) {
+            state->entries.erase(it);
+        }
+    }
+    delete finalizeHint;
+}
+
 } // namespace tools
 } // namespace napi
 } // namespace OHOS
@@ -1,15 +1,53 @@
 #ifndef OHOS_NAPI_FRAMEWORK_H
 #define OHOS_NAPI_FRAMEWORK_H
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cmath>
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <forward_list>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <napi/native_api.h>
+#include <new>
+#include <optional>
 #include <shared_mutex>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <typeinfo>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <variant>
+#include <vector>
 
 #if defined(CAPABLE_WITH_AKI)
 #include <aki/jsbind.h>
 #endif
 
+// 定义NAPI_FRAMEWORK_PORTABLE后只使用标准Node-API接口，不使用HarmonyOS扩展的NAPI接口
+// （如napi_create_object_with_named_properties），用于在其他NAPI实现上编译运行。
+
+// 定义NAPI_FRAMEWORK_NO_TYPE_TAG后Object::typeTag/checkTypeTag不使用napi_type_tag_object，改用隐藏的Symbol属性，
+// 用于头文件声明了该接口但运行时未实现的NAPI实现。
+#if defined(NAPI_FRAMEWORK_NO_TYPE_TAG) || NAPI_VERSION < 8
+#define NAPI_FRAMEWORK_HAS_TYPE_TAG 0
+#else
+#define NAPI_FRAMEWORK_HAS_TYPE_TAG 1
+#endif
+
 #define NAPI_CHECK_STATUS(env, status, message)                                                                        \
     if ((status) != napi_ok)                                                                                           \
     throw OHOS::napi::Exception(env, message)
@@ -40,6 +78,69 @@ private:
 };
 
 class Value;
+class Function;
+
+namespace details {
+/**
+ * HotValues 每线程缓存的常用单例值（undefined、null、true、false）
+ * napi_value只在创建它的handle scope内有效，因此缓存只在HotValueScope内生效：
+ * 进入时保存现场并清空缓存，退出时恢复，在内层scope中缓存的值随内层scope一起丢弃。
+ * NAPI_FUNC、tools::HandleScope以及框架注册的各个回调入口都会建立HotValueScope，不在任何HotValueScope内时不缓存。
+ * global是普通的对象句柄，不做缓存。
+ * @note 自行编写的napi_callback可能嵌套在NAPI_FUNC内执行（JS回调Native），其中若使用Env::undefined等，
+ * 应先建立HotValueScope或tools::HandleScope，否则取到的值会写入外层的缓存
+ */
+struct HotValues {
+    napi_env env = nullptr;
+    napi_value undefined = nullptr;
+    napi_value null = nullptr;
+    napi_value trueValue = nullptr;
+    napi_value falseValue = nullptr;
+    std::uint32_t depth = 0;
+
+    static HotValues &Current();
+    /// env对应的缓存，不在HotValueScope内时返回nullptr
+    static HotValues *For(napi_env env);
+};
+
+class HotValueScope {
+public:
+    HotValueScope();
+    ~HotValueScope();
+
+    HotValueScope(const HotValueScope &) = delete;
+    HotValueScope &operator=(const HotValueScope &) = delete;
+
+private:
+    HotValues saved_;
+};
+
+/**
+ * EnvLocal<T> 每个napi_env一份的T实例
+ * 首次在某个env中访问时默认构造，env销毁时由napi_add_env_cleanup_hook析构（此时仍可调用NAPI，如删除napi_ref）。
+ * 同一线程连续访问同一env时命中thread_local缓存，不加锁。须在env所属的JS线程上访问。
+ */
+template <typename T> class EnvLocal {
+public:
+    static T &Get(napi_env env);
+
+private:
+    struct Registry {
+        std::mutex mtx;
+        std::unordered_map<napi_env, std::unique_ptr<T>> instances;
+        // 每析构一个实例加一，使各线程的缓存失效（新env可能复用已销毁env的地址）
+        std::atomic<std::uint64_t> generation{0};
+    };
+    struct Cache {
+        napi_env env = nullptr;
+        T *instance = nullptr;
+        std::uint64_t generation = 0;
+    };
+
+    static Registry &GetRegistry();
+    static void Cleanup(void *arg);
+};
+} // namespace details
 
 // NAPI环境包装类
 // 禁止跨线程使用
@@ -56,6 +157,13 @@ public:
     Value undefined() const;
     // 获取null对象
     Value null() const;
+    // undefined与null在当前handle scope内只获取一次，见details::HotValues
+
+    /// 按名称获取构造函数。内置构造函数（如"Date"、"Map"）首次从global上读取，之后按env缓存其引用，
+    /// 每次只需一次napi_get_reference_value；导出的类须先通过registerConstructor登记
+    Function constructor(std::string_view name) const;
+    /// 登记构造函数（如napi_define_class的结果），替换同名的已有登记
+    void registerConstructor(std::string_view name, const Function &constructor) const;
 
 private:
     // napi_env 禁止缓存，因此设置此类为仅栈上创建使用
@@ -65,6 +173,121 @@ private:
     const napi_env env_;
 };
 
+namespace tools {
+
+/**
+ * CallArena 单次导出函数调用内的bump-pointer分配器
+ * 每个线程一个实例，NAPI_FUNC进入时通过Scope记录水位，返回时整体回退，期间的临时对象不再逐个malloc/free。
+ * 仅在存在活动Scope时生效，否则ArenaAllocator退化为普通的堆分配。
+ * @note 从CallArena分配的内存（包括ArenaString、ArenaVector以及String::asStringView的结果）
+ * 不能逃逸出当前调用，需要长期持有时请拷贝为std::string等普通容器。
+ * @note OHOS SDK自带的libc++尚未提供<memory_resource>，因此这里以标准Allocator的形式提供而非pmr。
+ */
+class CallArena {
+public:
+    // RAII：进入时记录当前线程arena的水位，退出时回退到该水位。可嵌套（JS回调Native再回调JS）
+    class Scope {
+    public:
+        Scope();
+        ~Scope();
+
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+    private:
+        CallArena &arena_;
+        void *block_;
+        std::size_t used_;
+    };
+
+    // RAII：期间Current()返回nullptr，分配退化为堆分配，退出时恢复。用于比当前调用活得久的代码（如协程体）
+    class Pause {
+    public:
+        Pause();
+        ~Pause();
+
+        Pause(const Pause &) = delete;
+        Pause &operator=(const Pause &) = delete;
+
+    private:
+        CallArena &arena_;
+        std::uint32_t depth_;
+    };
+
+    /// 当前线程活动的arena，没有活动的Scope时返回nullptr
+    static CallArena *Current();
+
+    void *allocate(std::size_t size, std::size_t alignment);
+    /// 仅当释放的是最后一次分配的内存时才真正回收（容器扩容的常见情况），否则等待Scope整体回退
+    void deallocate(void *p, std::size_t size) noexcept;
+    /// 当前已分配出去的字节数（含对齐填充）
+    std::size_t bytesInUse() const;
+
+    ~CallArena();
+
+private:
+    struct alignas(alignof(std::max_align_t)) Block {
+        Block *prev;
+        std::size_t capacity;
+        std::size_t used;
+        unsigned char *data() { return reinterpret_cast<unsigned char *>(this + 1); }
+    };
+
+    static constexpr std::size_t kMinBlockSize = 4096;
+    static constexpr std::size_t kMaxBlockSize = 64 * 1024;
+    static constexpr std::size_t kMaxSpareBytes = 256 * 1024; // 最外层Scope退出后保留的空闲块上限
+
+    CallArena() = default;
+    static CallArena &ThreadLocal();
+
+    void grow(std::size_t minSize);
+    void rewind(Block *block, std::size_t used);
+    void trimSpares();
+
+    Block *current_ = nullptr;
+    Block *spares_ = nullptr;
+    std::size_t spareBytes_ = 0;
+    std::size_t nextBlockSize_ = kMinBlockSize;
+    std::uint32_t depth_ = 0;
+};
+
+// 从当前CallArena分配的标准Allocator，构造时没有活动Scope则使用普通堆分配
+template <typename T> class ArenaAllocator {
+public:
+    using value_type = T;
+
+    ArenaAllocator() noexcept : arena_(CallArena::Current()) {}
+    explicit ArenaAllocator(CallArena *arena) noexcept : arena_(arena) {}
+    template <typename U> ArenaAllocator(const ArenaAllocator<U> &other) noexcept : arena_(other.arena()) {}
+
+    T *allocate(std::size_t n) {
+        if (arena_ != nullptr) {
+            return static_cast<T *>(arena_->allocate(n * sizeof(T), alignof(T)));
+        }
+        return static_cast<T *>(::operator new(n * sizeof(T)));
+    }
+    void deallocate(T *p, std::size_t n) noexcept {
+        if (arena_ != nullptr) {
+            arena_->deallocate(p, n * sizeof(T));
+        } else {
+            ::operator delete(p);
+        }
+    }
+
+    CallArena *arena() const noexcept { return arena_; }
+
+    template <typename U> bool operator==(const ArenaAllocator<U> &other) const { return arena_ == other.arena(); }
+    template <typename U> bool operator!=(const ArenaAllocator<U> &other) const { return arena_ != other.arena(); }
+
+private:
+    CallArena *arena_;
+};
+
+using ArenaString = std::basic_string<char, std::char_traits<char>, ArenaAllocator<char>>;
+template <typename T> using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+} // namespace tools
+
 // forward declarations
 class Boolean;
 class Number;
@@ -73,6 +296,47 @@ class String;
 class Object;
 class Function;
 class Array;
+class ArrayBuffer;
+class TypedArray;
+template <typename T> class TypedArrayOf;
+class DataView;
+
+namespace tools {
+class PooledBuffer;
+
+/// 128位类型标记，取值应全局唯一（如一个UUID）
+struct TypeTag {
+    std::uint64_t lower;
+    std::uint64_t upper;
+
+    bool operator==(const TypeTag &other) const { return lower == other.lower && upper == other.upper; }
+    bool operator<(const TypeTag &other) const {
+        return upper != other.upper ? upper < other.upper : lower < other.lower;
+    }
+};
+
+/// T的默认类型标记，由T的类型名散列得到
+template <typename T> const TypeTag &TypeTagOf();
+} // namespace tools
+
+/**
+ * Converter<T> C++类型与JS值之间的双向转换
+ * 框架内置了以下类型的特化：
+ * - napi::Value及其子类、napi_value
+ * - bool、各种整数（按位宽精确分派到int32/uint32/int64）、浮点数、枚举（按底层类型）
+ *   @note 64位整数的ToJS结果是number，绝对值超过2^53时会丢失精度；需要精确值时请用BigInt::Create
+ *   或Converter<__int128>。FromJS同时接受number与BigInt，无符号整数的NaN与负数取0，过大的值取最大值
+ * - std::string、std::string_view、std::u16string、const char*、const char16_t*
+ * - std::optional、std::variant、std::monostate
+ * - std::vector、std::array、std::pair、std::tuple（JS数组），std::vector也可以从元素类型相同的TypedArray整块拷贝
+ * - __int128、unsigned __int128（BigInt）
+ * - std::map、std::unordered_map（JS对象）
+ * 自定义类型可以特化Converter，提供以下静态函数（按需）：
+ *   static napi_value ToJS(napi_env env, const T &value);
+ *   static T FromJS(napi_env env, napi_value value);
+ *   static bool Is(napi_env env, napi_value value); // 用于std::variant的FromJS选择类型
+ */
+template <typename T, typename Enable = void> struct Converter;
 
 class Value {
 public:
@@ -100,10 +364,13 @@ public:
     bool isExternal() const { return type() == napi_external; }
     bool isBigInt() const { return type() == napi_bigint; }
     bool isArray() const;
+    bool isArrayBuffer() const;
+    bool isTypedArray() const;
+    bool isDataView() const;
 
-    /// Creates a JS value from a C++ primitive.
+    /// Creates a JS value from a C++ value.
     ///
-    /// `value` may be any of:
+    /// `value` may be of any type supported by `Converter<T>`, e.g.:
     /// - bool
     /// - Any integer type
     /// - Any floating point type
@@ -111,11 +378,14 @@ public:
     /// - const char16_t* (encoded using UTF-16-LE, null-terminated)
     /// - std::string (encoded using UTF-8)
     /// - std::u16string
+    /// - std::vector, std::map, std::optional, std::tuple, std::variant ...
     /// - napi::Value
     /// - napi_value
     template <typename T> static Value From(napi_env env, const T &value);
     template <typename NapiValue>
     typename std::enable_if<std::is_base_of<Value, NapiValue>::value, NapiValue>::type as() const;
+    /// Converts to a C++ value through `Converter<T>`, e.g. `cbInfo[0].as<std::vector<int>>()`.
+    template <typename T> typename std::enable_if<!std::is_base_of<Value, T>::value, T>::type as() const;
 
     Boolean toBoolean() const; ///< Coerces a value to a JavaScript boolean.
     Number toNumber() const;   ///< Coerces a value to a JavaScript number.
@@ -164,9 +434,24 @@ public:
 
 class BigInt : public Value {
 public:
+    /// 至多N个64位字的BigInt，字存放在对象内部，读写都不分配堆内存
+    template <std::size_t N> struct Words {
+        int signBit = 0;
+        /// 实际需要的字数，大于N表示读取时被截断（只保留了低N个字）
+        std::size_t count = 0;
+        std::array<std::uint64_t, N> data{};
+
+        bool truncated() const { return count > N; }
+    };
+
     static BigInt Create(napi_env env, std::int64_t value);
     static BigInt Create(napi_env env, std::uint64_t value);
     static BigInt Create(napi_env env, int signBit, std::size_t wordCount, const std::uint64_t *words);
+    template <std::size_t N> static BigInt Create(napi_env env, const Words<N> &words);
+#ifdef __SIZEOF_INT128__
+    static BigInt Create(napi_env env, __int128 value);
+    static BigInt Create(napi_env env, unsigned __int128 value);
+#endif
 
     BigInt(napi_env env) : Value(env) {}
     BigInt(napi_env env, napi_value value) : Value(env, value) {}
@@ -182,6 +467,14 @@ public:
     /// Upon return, it will be set to the actual number of words that would
     /// be needed to store this BigInt (i.e. the return value of `WordCount()`).
     void toWords(int *signBit, std::size_t *wordCount, std::uint64_t *words) const;
+    /// 一次调用读取至多N个字，无需先查询wordCount
+    template <std::size_t N> Words<N> toWords() const;
+
+#ifdef __SIZEOF_INT128__
+    /// 按2^128取模截断，与asInt64/asUint64语义一致
+    __int128 asInt128(bool *lossless = nullptr) const;
+    unsigned __int128 asUint128(bool *lossless = nullptr) const;
+#endif
 };
 
 class Named : public Value {
@@ -204,8 +497,13 @@ public:
     //    const char *asCString() const;
     operator std::string() const; ///< Converts a String value to a UTF-8 encoded C++ string.
     std::string asString() const; ///< Converts a String value to a UTF-8 encoded C++ string.
+    /// Converts a String value to a UTF-8 encoded view without a heap allocation.
+    /// 结果分配在当前的CallArena上，在NAPI_FUNC返回前有效；
+    /// 没有活动的CallArena时每次调用的结果各自保存在本对象中，随本对象销毁失效（再次调用不会使之前的结果失效）。
+    std::string_view asStringView() const;
+
 private:
-    std::string result_;
+    mutable std::forward_list<std::string> results_; // 没有活动的CallArena时asStringView的结果
 };
 
 class Object : public Value {
@@ -225,16 +523,19 @@ public:
         friend class Object;
 
     public:
-        operator Value() const { return Object(env_, object_).get(key_); }
+        operator Value() const { return Object(env_, object_).get(keyArg(key_)); }
         /// Assigns a value to the property. The type of value can be anything supported by `Object::set`.
         template <typename ValueType> PropertyLValue &operator=(ValueType value) {
-            Object(env_, object_).set(key_, value);
+            Object(env_, object_).set(keyArg(key_), value);
             return *this;
         }
         Value asValue() const { return Value(*this); }
 
     private:
-        PropertyLValue(Object object, Key key) : env_(object.env()), object_(object), key_(key) {}
+        PropertyLValue(Object object, Key key) : env_(object.env()), object_(object), key_(std::move(key)) {}
+
+        static const char *keyArg(const tools::ArenaString &key) { return key.c_str(); }
+        template <typename K> static const K &keyArg(const K &key) { return key; }
 
         const napi_env env_;
         napi_value object_;
@@ -261,9 +562,10 @@ public:
     bool hasOwnProperty(const std::string &utf8name) const;
 
     /// Gets or sets a named property.
-    PropertyLValue<std::string> operator[](const char *utf8name);
+    /// 属性名拷贝在当前的CallArena上，因此返回的PropertyLValue不能逃逸出当前调用
+    PropertyLValue<tools::ArenaString> operator[](const char *utf8name);
     /// Gets or sets a named property.
-    PropertyLValue<std::string> operator[](const std::string &utf8name);
+    PropertyLValue<tools::ArenaString> operator[](const std::string &utf8name);
     /// Gets or sets an indexed property or array element.
     PropertyLValue<std::uint32_t> operator[](std::uint32_t index);
     /// Gets or sets an indexed property or array element.
@@ -310,6 +612,16 @@ public:
 
     /// Checks if an object is an instance created by a constructor function.
     bool instanceof (const Function &constructor) const;
+    /// 同上，构造函数通过Env::constructor按名称从缓存中获取
+    bool instanceof (std::string_view constructorName) const;
+
+    /// 为对象打上类型标记（napi_type_tag_object，不支持时以隐藏的Symbol属性代替），同一对象只能标记一次
+    void typeTag(const tools::TypeTag &tag) const;
+    /// 以一次调用检查对象是否带有tag标记，不是对象时返回false
+    bool checkTypeTag(const tools::TypeTag &tag) const;
+    /// 以tools::TypeTagOf<T>()标记对象，表明它由本模块按T创建，如wrap<T>之后
+    template <typename T> void brand() const { typeTag(tools::TypeTagOf<T>()); }
+    template <typename T> bool isBranded() const { return checkTypeTag(tools::TypeTagOf<T>()); }
 
     class const_iterator;
     const_iterator begin() const;
@@ -320,18 +632,90 @@ public:
 
     bool freeze() const;
     bool seal() const;
+
+    /**
+     * 将Native对象绑定到本JS对象，JS对象被回收时delete native。
+     * byteLength为native实际持有的内存（包括其间接持有的堆内存），按category计入tools::MemoryAccounting并告知GC。
+     * @note category须为静态存储期的字符串
+     */
+    template <typename T>
+    void wrap(T *native, std::size_t byteLength = sizeof(T), const char *category = "wrap") const;
+    /// 取出wrap绑定的Native对象，T必须与wrap时一致；未绑定时返回nullptr
+    template <typename T> T *unwrap() const;
+    /// 解除绑定并交回Native对象的所有权，同时扣除记账；未绑定时返回nullptr
+    template <typename T> std::unique_ptr<T> removeWrap() const;
+};
+
+namespace details {
+// 闭包的定长内存块，按线程缓存空闲块。函数的finalizer在创建它的JS线程上执行，因此同一块总是在同一线程上分配与回收。
+class ClosureBlockPool {
+public:
+    static constexpr std::size_t kBlockSize = 64;
+
+    static void *Acquire();
+    static void Release(void *block);
+
+private:
+    struct Node {
+        Node *next;
+    };
+    struct FreeList {
+        Node *head = nullptr;
+        std::size_t count = 0;
+        ~FreeList();
+    };
+    static constexpr std::size_t kMaxCached = 4096;
+    static FreeList &Local();
+};
+
+template <typename F>
+using EnableIfClosure = std::enable_if_t<!std::is_convertible<std::decay_t<F>, napi_callback>::value>;
+
+struct IdentityMapper {
+    template <typename T> const T &operator()(const T &item) const { return item; }
+};
+} // namespace details
+
+struct CallEachOptions {
+    std::size_t chunkSize = 64; ///< 每处理这么多项关闭并重新打开一次handle scope
+    bool stopOnFalse = false;   ///< 回调返回false时停止后续调用
 };
 
 class Function : public Object {
 public:
     static Function Create(napi_env env, const char *utf8name, napi_callback callback, void *data = nullptr);
     static Function Create(napi_env env, const std::string &utf8name, napi_callback callback, void *data = nullptr);
+    /**
+     * 以任意可调用对象创建函数，签名为`R(const CallbackInfo &)`或`R()`，R通过Converter转换为JS值，void对应undefined。
+     * 不超过ClosureBlockPool::kBlockSize的闭包就地存放在复用的定长内存块中，由函数的finalizer析构并回收，
+     * 调用时经由按闭包类型特化的跳板函数直接调用，没有std::function的类型擦除与额外分配。
+     * 闭包抛出的C++异常会转换为JS Error抛出。
+     */
+    template <typename Callable, typename = details::EnableIfClosure<Callable>>
+    static Function Create(napi_env env, const char *utf8name, Callable &&callable);
+    template <typename Callable, typename = details::EnableIfClosure<Callable>>
+    static Function Create(napi_env env, const std::string &utf8name, Callable &&callable);
 
     Function(napi_env env) : Object(env) {}
     Function(napi_env env, napi_value value) : Object(env, value) {}
 
     Value call(Value recv, const std::initializer_list<Value> &args) const;
     Value call(const std::initializer_list<napi_value> &args) const;
+    /// 以undefined为this调用，每个参数通过Converter转换
+    template <typename... Args> Value operator()(const Args &...args) const;
+
+    /**
+     * 对range中的每一项调用一次本函数，以undefined为this，参数为mapper(item)经Converter转换的结果；
+     * mapper返回std::tuple时展开为多个参数。所有调用共用同一个参数数组，每chunkSize项一个handle scope。
+     * @return 实际调用的次数（stopOnFalse时可能少于range的长度）
+     */
+    template <typename Range, typename Mapper = details::IdentityMapper>
+    std::size_t callEach(const Range &range, Mapper mapper = Mapper(),
+                         const CallEachOptions &options = CallEachOptions()) const;
+    /// 将range中每一项mapper(item)的结果打包成一个数组，只调用一次本函数。
+    /// 结果为算术类型时打包为对应的TypedArray，否则为Array。
+    template <typename Range, typename Mapper = details::IdentityMapper>
+    Value callCoalesced(const Range &range, Mapper mapper = Mapper()) const;
 };
 
 class Array : public Object {
@@ -345,6 +729,134 @@ public:
     std::uint32_t length() const;
 };
 
+class ArrayBuffer : public Object {
+public:
+    static ArrayBuffer Create(napi_env env, std::size_t byteLength);
+    /// 以Native内存创建ArrayBuffer，不发生拷贝。
+    /// `finalizer`在JS侧回收该ArrayBuffer后调用，签名为`void(void *data)`。
+    /// @note 默认在tools::Reclaimer的后台线程上调用，不能访问任何JS值；需要在JS线程上调用时以
+    /// tools::OnJSThread(fn)包装（早先的版本总是在JS线程的finalizer中直接调用）。
+    /// `byteLength`会通过napi_adjust_external_memory报告给GC，回收时扣除。
+    template <typename Finalizer>
+    static ArrayBuffer CreateExternal(napi_env env, void *data, std::size_t byteLength, Finalizer finalizer);
+    /// 同上，`finalizer`签名为`void(void *data, Hint *hint)`。
+    template <typename Finalizer, typename Hint>
+    static ArrayBuffer CreateExternal(napi_env env, void *data, std::size_t byteLength, Finalizer finalizer,
+                                      Hint *hint);
+    /// 将池化缓冲区的所有权移交给JS，JS侧回收后缓冲区自动归还到所属的BufferPool。
+    /// 创建失败时`buffer`保持不变。
+    static ArrayBuffer CreateExternal(napi_env env, tools::PooledBuffer &&buffer);
+
+    ArrayBuffer(napi_env env) : Object(env) {}
+    ArrayBuffer(napi_env env, napi_value value) : Object(env, value) {}
+
+    void *data() const;
+    std::size_t byteLength() const;
+};
+
+class TypedArray : public Object {
+public:
+    TypedArray(napi_env env) : Object(env) {}
+    TypedArray(napi_env env, napi_value value) : Object(env, value) {}
+
+    napi_typedarray_type typedArrayType() const;
+    /// 元素个数
+    std::size_t elementLength() const;
+    std::size_t byteOffset() const;
+    ArrayBuffer arrayBuffer() const;
+};
+
+namespace details {
+template <typename T> struct TypedArrayTypeOf;
+template <> struct TypedArrayTypeOf<std::int8_t> : std::integral_constant<napi_typedarray_type, napi_int8_array> {};
+template <> struct TypedArrayTypeOf<std::uint8_t> : std::integral_constant<napi_typedarray_type, napi_uint8_array> {};
+template <> struct TypedArrayTypeOf<std::int16_t> : std::integral_constant<napi_typedarray_type, napi_int16_array> {};
+template <> struct TypedArrayTypeOf<std::uint16_t> : std::integral_constant<napi_typedarray_type, napi_uint16_array> {};
+template <> struct TypedArrayTypeOf<std::int32_t> : std::integral_constant<napi_typedarray_type, napi_int32_array> {};
+template <> struct TypedArrayTypeOf<std::uint32_t> : std::integral_constant<napi_typedarray_type, napi_uint32_array> {};
+template <> struct TypedArrayTypeOf<float> : std::integral_constant<napi_typedarray_type, napi_float32_array> {};
+template <> struct TypedArrayTypeOf<double> : std::integral_constant<napi_typedarray_type, napi_float64_array> {};
+template <>
+struct TypedArrayTypeOf<std::int64_t> : std::integral_constant<napi_typedarray_type, napi_bigint64_array> {};
+template <>
+struct TypedArrayTypeOf<std::uint64_t> : std::integral_constant<napi_typedarray_type, napi_biguint64_array> {};
+// T是否有对应的TypedArray类型
+template <typename T, typename = void> struct HasTypedArray : std::false_type {};
+template <typename T>
+struct HasTypedArray<T, std::void_t<decltype(TypedArrayTypeOf<T>::value)>> : std::true_type {};
+} // namespace details
+
+// 元素类型为T的TypedArray，如TypedArrayOf<float>对应Float32Array
+template <typename T> class TypedArrayOf : public TypedArray {
+public:
+    static constexpr napi_typedarray_type kType = details::TypedArrayTypeOf<T>::value;
+
+    /// 创建新的ArrayBuffer及其上的TypedArray
+    static TypedArrayOf Create(napi_env env, std::size_t length);
+    /// 在已有的ArrayBuffer上创建TypedArray
+    static TypedArrayOf Create(napi_env env, std::size_t length, const ArrayBuffer &buffer, std::size_t byteOffset);
+    /// 拷贝data[0, length)创建TypedArray，整块memcpy，int64/uint64不会逐个创建BigInt
+    static TypedArrayOf Create(napi_env env, const T *data, std::size_t length);
+
+    TypedArrayOf(napi_env env) : TypedArray(env) {}
+    TypedArrayOf(napi_env env, napi_value value) : TypedArray(env, value) {}
+
+    /// 首个元素的地址（已计入byteOffset）
+    T *data() const;
+    std::size_t length() const { return elementLength(); }
+    /// 整块拷贝出全部元素
+    std::vector<T> toVector() const;
+};
+
+class DataView : public Object {
+public:
+    /// 在已有的ArrayBuffer的[byteOffset, byteOffset + byteLength)上创建DataView
+    static DataView Create(napi_env env, const ArrayBuffer &buffer, std::size_t byteOffset, std::size_t byteLength);
+
+    DataView(napi_env env) : Object(env) {}
+    DataView(napi_env env, napi_value value) : Object(env, value) {}
+
+    std::size_t byteLength() const;
+    std::size_t byteOffset() const;
+    ArrayBuffer arrayBuffer() const;
+    /// 视图首字节的地址（已计入byteOffset）
+    std::uint8_t *data() const;
+};
+
+/**
+ * ObjectTemplate 固定属性布局的对象模板
+ * 声明一次属性名列表，之后每个对象只需一次NAPI调用即可创建并填充全部属性
+ * （napi_create_object_with_named_properties，PORTABLE模式下为napi_define_properties），
+ * 同一模板创建的对象属性顺序一致，引擎可以共享同一个hidden class。
+ */
+class ObjectTemplate {
+public:
+    ObjectTemplate(std::initializer_list<const char *> names);
+    explicit ObjectTemplate(std::vector<std::string> names);
+
+    // keys_指向names_中各字符串的内容：拷贝得到的keys_会指向源对象，因此禁止拷贝；
+    // 移动时vector的存储整体转移，字符串地址不变
+    ObjectTemplate(const ObjectTemplate &) = delete;
+    ObjectTemplate &operator=(const ObjectTemplate &) = delete;
+    ObjectTemplate(ObjectTemplate &&) = default;
+    ObjectTemplate &operator=(ObjectTemplate &&) = default;
+
+    std::size_t size() const { return names_.size(); }
+    const std::vector<std::string> &names() const { return names_; }
+
+    /// 以values创建对象，values的个数必须等于属性个数
+    Object createFrom(napi_env env, const napi_value *values) const;
+    /// 以任意可被Value::From转换的值按属性顺序创建对象
+    template <typename... Ts> Object create(napi_env env, const Ts &...values) const;
+    /// 创建count个对象组成的数组，`filler(std::size_t index, napi_value *values)`填充第index个对象的各属性值。
+    /// 每创建一批对象关闭一次handle scope，避免大数组时句柄堆积。
+    template <typename Filler> Array createArray(napi_env env, std::size_t count, Filler filler) const;
+
+private:
+    std::vector<std::string> names_;
+    std::vector<const char *> keys_;
+};
+
 // TODO 其他JS类型暂时用不到
 
 // 函数元信息包装类
@@ -353,6 +865,8 @@ class CallbackInfo {
     CallbackInfo(const CallbackInfo &) = delete;
 
 public:
+    using ArgList = tools::ArenaVector<Value>;
+
     CallbackInfo(napi_env env, napi_callback_info info, std::size_t argc) : env_(env), info_(info) {
         // 初始化参数列表
         NAPI_CHECK_STATUS(env_, napi_get_cb_info(env, info_, &argc, nullptr, nullptr, nullptr),
@@ -377,7 +891,7 @@ public:
     Env env() const { return Env(env_); }
     napi_callback_info info() const { return info_; }
     operator napi_callback_info() const { return info_; }
-    const std::vector<Value> &args() const { return args_; }
+    const ArgList &args() const { return args_; }
     std::size_t argCount() const { return args_.size(); }
     Value argAt(std::size_t index) const { return args_.at(index); }
     Value operator[](std::size_t index) const { return index < args_.size() ? args_[index] : env().undefined(); }
@@ -385,7 +899,7 @@ public:
 private:
     const napi_env env_;
     napi_callback_info info_; // 从中可以提取出参数信息
-    std::vector<Value> args_;
+    ArgList args_;            // 分配在当前的CallArena上
 };
 
 namespace tools {
@@ -409,6 +923,7 @@ public:
 private:
     const napi_env env_;
     napi_handle_scope scope_;
+    details::HotValueScope hotValueScope_; // 本scope内缓存的单例值随本scope关闭而丢弃
 };
 
 template <typename T>
@@ -442,6 +957,305 @@ public:
 protected:
     napi_env env_;
     napi_ref ref_;
+    std::thread::id owner_; // 创建引用的JS线程，在其他线程上释放时交给Reclaimer
+};
+
+/// 只能移动的Reference：没有经由handle scope新建napi_ref的拷贝构造，适合在容器中持有。
+/// 私有继承，不能转换为Reference<T>，以免经由其拷贝构造新建napi_ref或经由其引用切片赋值
+template <typename T> class UniqueReference : private Reference<T> {
+public:
+    static UniqueReference Create(const T &value, std::uint32_t initial = 1);
+
+    using Reference<T>::operator napi_ref;
+    using Reference<T>::ref;
+    using Reference<T>::unref;
+    using Reference<T>::reset;
+    using Reference<T>::env;
+    using Reference<T>::value;
+
+    UniqueReference() : Reference<T>(nullptr, nullptr) {}
+    UniqueReference(napi_env env, napi_ref ref) : Reference<T>(env, ref) {}
+
+    UniqueReference(UniqueReference &&other) : Reference<T>(std::move(other)) {}
+    UniqueReference &operator=(UniqueReference &&other);
+    UniqueReference(const UniqueReference &) = delete;
+    UniqueReference &operator=(const UniqueReference &) = delete;
+
+    bool empty() const { return this->ref_ == nullptr; }
+};
+
+/**
+ * ReferenceTable 以紧凑的整数句柄持有大量JS值
+ * 强引用的值存放在同一个JS数组中，整个表只有一个napi_ref：持有一个值只需一次napi_set_element，
+ * Native侧每个值只占一个16字节的槽位，不再为每个值分配napi_ref。
+ * 弱引用的槽位单独持有一个引用计数为0的napi_ref，值被回收后get返回空。
+ * 句柄由槽位下标与槽位代数组成，槽位释放后代数加一，旧句柄随之失效，不会误取到复用该槽位的新值。
+ * @note 只能在创建它的env的JS线程上使用
+ */
+class ReferenceTable {
+public:
+    /// 低32位为槽位下标，高32位为槽位代数，kInvalid不对应任何值
+    using Handle = std::uint64_t;
+    static constexpr Handle kInvalid = 0;
+
+    explicit ReferenceTable(napi_env env) : env_(env) {}
+    ~ReferenceTable();
+
+    ReferenceTable(const ReferenceTable &) = delete;
+    ReferenceTable &operator=(const ReferenceTable &) = delete;
+
+    napi_env env() const { return env_; }
+
+    /// 强持有value
+    Handle add(const Value &value);
+    /// 批量强持有values[0, count)，句柄依次写入handles。追加到表尾的部分每8192个值只需一次Array.prototype.push调用
+    void add(const napi_value *values, std::size_t count, Handle *handles);
+    /// 弱持有value，不阻止它被回收
+    Handle addWeak(const Value &value);
+    /// 取出句柄对应的值；句柄已失效或弱引用的值已被回收时返回空的Value（isEmpty()为true）
+    Value get(Handle handle) const;
+    bool contains(Handle handle) const;
+    /// 释放句柄，已失效的句柄被忽略
+    void release(Handle handle);
+    /// 批量释放，整批只取一次存放强引用的数组
+    template <typename It> void release(It first, It last);
+    /// 释放全部句柄
+    void clear();
+    /// 持有中的句柄数
+    std::size_t size() const { return size_; }
+
+private:
+    static constexpr std::uint32_t kNoSlot = UINT32_MAX;
+    static constexpr std::uint32_t kUsed = UINT32_MAX - 1; // 使用中的槽位的nextFree
+
+    struct Slot {
+        napi_ref weak = nullptr; // 弱引用槽位的napi_ref
+        std::uint32_t generation = 1;
+        std::uint32_t nextFree = kNoSlot;
+    };
+
+    static Handle MakeHandle(std::uint32_t index, std::uint32_t generation) {
+        return (static_cast<Handle>(generation) << 32) | index;
+    }
+    // 句柄对应的使用中的槽位，失效时返回nullptr
+    const Slot *find(Handle handle) const;
+    std::uint32_t allocate();
+    napi_value values() const;
+    void releaseSlot(std::uint32_t index, napi_value values);
+
+    napi_env env_;
+    std::thread::id owner_ = std::this_thread::get_id();
+    mutable UniqueReference<Array> values_; // 存放强引用值的JS数组，首次add时创建
+    std::vector<Slot> slots_;
+    std::uint32_t freeHead_ = kNoSlot;
+    std::size_t size_ = 0;
+};
+
+/**
+ * MemoryAccounting JS对象背后Native内存的记账
+ * 外部ArrayBuffer、Object::wrap绑定的Native对象等在创建时记入字节数，回收时扣除，
+ * 同时通过napi_adjust_external_memory告知GC，使持有大块Native内存的小JS对象能被及时回收。
+ * 按类别统计字节数与对象个数，可在任意线程读取；add/remove须在JS线程调用。
+ */
+class MemoryAccounting {
+public:
+    static constexpr const char *kArrayBuffer = "ArrayBuffer";
+    static constexpr const char *kWrap = "wrap";
+
+    struct Usage {
+        std::int64_t bytes = 0;
+        std::int64_t count = 0;
+    };
+
+    static MemoryAccounting &Instance() {
+        static MemoryAccounting inst;
+        return inst;
+    }
+
+    void add(napi_env env, const char *category, std::size_t byteLength);
+    void remove(napi_env env, const char *category, std::size_t byteLength);
+
+    Usage usage(std::string_view category) const;
+    Usage total() const;
+    std::map<std::string, Usage, std::less<>> snapshot() const;
+
+private:
+    MemoryAccounting() = default;
+
+    mutable std::mutex mtx_;
+    std::map<std::string, Usage, std::less<>> categories_;
+    Usage total_;
+};
+
+/// 一笔记账的RAII凭证，析构时扣除，须在JS线程析构
+class Accounted {
+public:
+    Accounted() = default;
+    Accounted(napi_env env, const char *category, std::size_t byteLength);
+    ~Accounted() { reset(); }
+
+    Accounted(Accounted &&other) noexcept;
+    Accounted &operator=(Accounted &&other) noexcept;
+    Accounted(const Accounted &) = delete;
+    Accounted &operator=(const Accounted &) = delete;
+
+    /// 调整记账的字节数，如Native对象扩容或收缩后
+    void resize(std::size_t byteLength);
+    void reset();
+    std::size_t byteLength() const { return byteLength_; }
+
+private:
+    napi_env env_ = nullptr;
+    const char *category_ = nullptr;
+    std::size_t byteLength_ = 0;
+};
+
+/// 类型T的Native对象是否必须在JS线程上析构。
+/// 默认为false：框架的finalizer（Object::wrap、外部ArrayBuffer）只在JS线程上扣除记账，
+/// 析构交给Reclaimer的后台线程分批执行，避免GC时在JS线程上释放大对象造成卡顿。
+/// 析构过程依赖JS线程（访问NAPI、线程不安全的全局状态等）的类型应特化为std::true_type。
+template <typename T> struct FinalizeOnJSThread : std::false_type {};
+
+/// 使外部ArrayBuffer的finalizer在JS线程上执行：`ArrayBuffer::CreateExternal(env, data, len, OnJSThread(fn))`
+template <typename F> struct JSThreadFinalizer {
+    F fn;
+    template <typename... Args> void operator()(Args &&...args) { fn(std::forward<Args>(args)...); }
+};
+template <typename F> struct FinalizeOnJSThread<JSThreadFinalizer<F>> : std::true_type {};
+
+template <typename F> JSThreadFinalizer<std::decay_t<F>> OnJSThread(F &&fn) { return {std::forward<F>(fn)}; }
+
+/**
+ * Reclaimer 后台回收线程
+ * finalizer把待析构的Native对象放入队列，后台线程每次取走整个队列批量析构。
+ * 在非JS线程上析构的Reference也经由这里把napi_ref送回JS线程删除。
+ * 后台线程在第一次使用时启动。
+ */
+class Reclaimer {
+public:
+    using Deleter = void (*)(void *);
+
+    static Reclaimer &Instance() {
+        static Reclaimer inst;
+        return inst;
+    }
+
+    ~Reclaimer();
+    Reclaimer(const Reclaimer &) = delete;
+    Reclaimer &operator=(const Reclaimer &) = delete;
+
+    /// 交给后台线程调用deleter(ptr)
+    void retire(void *ptr, Deleter deleter);
+    /// FinalizeOnJSThread<T>为true时立即delete，否则交给后台线程
+    template <typename T> void retire(T *ptr);
+    /// 等待此前交付的对象全部析构完毕
+    void flush();
+    /// 尚未析构的对象个数
+    std::size_t pending() const;
+
+    /// 在非JS线程上释放napi_ref：先排队，回到env的JS线程后删除。
+    /// 非PORTABLE模式下通过napi_send_event立即投递到JS线程，PORTABLE模式下在该env下一次创建Reference时
+    /// 或该env清理时删除。
+    void retireReference(napi_env env, napi_ref ref);
+    /// 在JS线程上删除env中排队的napi_ref
+    void drainReferences(napi_env env);
+
+private:
+#ifdef NAPI_FRAMEWORK_PORTABLE
+    // 为env注册一次清理钩子，env清理时删除仍在排队的napi_ref
+    void watchEnv(napi_env env);
+    static void OnEnvCleanup(void *arg);
+    // 本线程最近一次注册过钩子的env
+    static napi_env &WatchedEnv();
+#endif
+    void deleteReferences(napi_env env);
+
+    struct Item {
+        void *ptr;
+        Deleter deleter;
+    };
+
+    Reclaimer() = default;
+    void run();
+
+    mutable std::mutex mtx_;
+    std::condition_variable wakeup_;
+    std::condition_variable idle_;
+    std::vector<Item> queue_;
+    std::size_t inFlight_ = 0;
+    bool stop_ = false;
+    std::thread thread_;
+
+    std::mutex refMtx_;
+    std::unordered_map<napi_env, std::vector<napi_ref>> refs_;
+    std::atomic<std::size_t> pendingRefs_{0};
+#ifdef NAPI_FRAMEWORK_PORTABLE
+    std::unordered_set<napi_env> watched_;
+#endif
+};
+
+/**
+ * BufferPool 按尺寸分级的Native缓冲区池
+ * 尺寸级别为每个2的幂次再四等分（如8M、10M、12M、14M），浪费不超过25%。
+ * 可在任意线程acquire/归还，内部加锁。
+ * 借出的缓冲区持有池的共享状态，因此池本身先于缓冲区析构也是安全的：此时归还的缓冲区直接释放。
+ */
+class BufferPool {
+    struct State;
+    friend class PooledBuffer;
+
+public:
+    /// @param maxCachedPerClass 每个尺寸级别最多缓存的空闲缓冲区个数
+    /// @param minBlockSize 最小的尺寸级别，须为不小于4的2的幂次，否则抛出std::invalid_argument
+    explicit BufferPool(std::size_t maxCachedPerClass = 4, std::size_t minBlockSize = 4096);
+    ~BufferPool();
+
+    BufferPool(const BufferPool &) = delete;
+    BufferPool &operator=(const BufferPool &) = delete;
+
+    /// 获取容量不小于size的缓冲区，优先复用缓存。size超过最大的尺寸级别时抛出std::length_error
+    PooledBuffer acquire(std::size_t size);
+    /// 当前缓存（未借出）的总字节数
+    std::size_t cachedBytes() const;
+    /// 释放所有缓存的空闲缓冲区
+    void trim();
+
+    static std::size_t sizeClassOf(std::size_t size, std::size_t minBlockSize);
+
+private:
+    std::shared_ptr<State> state_;
+};
+
+// 从BufferPool借出的缓冲区，析构时归还给池
+class PooledBuffer {
+    friend class BufferPool;
+
+public:
+    PooledBuffer() = default;
+    ~PooledBuffer() { reset(); }
+
+    // A pooled buffer can be moved but cannot be copied.
+    PooledBuffer(PooledBuffer &&other) noexcept;
+    PooledBuffer &operator=(PooledBuffer &&other) noexcept;
+    PooledBuffer(const PooledBuffer &) = delete;
+    PooledBuffer &operator=(const PooledBuffer &) = delete;
+
+    void *data() const { return data_; }
+    std::size_t size() const { return size_; }
+    std::size_t capacity() const { return capacity_; }
+    explicit operator bool() const { return data_ != nullptr; }
+
+    /// 提前归还给池
+    void reset();
+
+private:
+    PooledBuffer(std::shared_ptr<BufferPool::State> state, void *data, std::size_t size, std::size_t capacity)
+        : state_(std::move(state)), data_(data), size_(size), capacity_(capacity) {}
+
+    std::shared_ptr<BufferPool::State> state_;
+    void *data_ = nullptr;
+    std::size_t size_ = 0;
+    std::size_t capacity_ = 0;
 };
 
 /**
@@ -454,7 +1268,7 @@ class Reflector {
     Reflector &operator=(const Reflector &) = delete;
 
 public:
-    using JSFuncsMap = std::unordered_map<std::string, Reference<Function>>;
+    using JSFuncsMap = std::unordered_map<std::string, UniqueReference<Function>>;
 
     static Reflector &Instance() {
         static Reflector inst;
@@ -473,28 +1287,34 @@ public:
         std::unique_lock lck(mtx_);
         auto it = jsFuncsMap_.find(alias);
         if (it != jsFuncsMap_.end()) {
-            it->second.unref();
+            it->second.reset(func, 1);
+        } else {
+            jsFuncsMap_.emplace(alias, UniqueReference<Function>::Create(func, 1));
         }
-        jsFuncsMap_.emplace(alias, Reference<Function>::Create(func, 1));
     }
 
     void unbindFunc(const std::string &alias) {
         std::unique_lock lck(mtx_);
+        jsFuncsMap_.erase(alias);
+    }
+
+    Value callBoundFunc(const std::string &alias, const std::initializer_list<napi_value> &args) {
+        std::shared_lock lck(mtx_);
         auto it = jsFuncsMap_.find(alias);
         if (it != jsFuncsMap_.end()) {
-            it->second.unref();
+            // 引用计数在绑定时已为1，调用期间无需再ref/unref
+            return it->second.value().call(std::move(args));
+        } else {
+            throw std::runtime_error("Function not found");
         }
-        jsFuncsMap_.erase(alias);
     }
 
-    Value callBoundFunc(const std::string &alias, const std::initializer_list<napi_value> &args) {
+    /// 同上，每个参数通过Converter转换
+    template <typename... Args> Value callBoundFunc(const std::string &alias, const Args &...args) {
         std::shared_lock lck(mtx_);
         auto it = jsFuncsMap_.find(alias);
         if (it != jsFuncsMap_.end()) {
-            it->second.ref();
-            auto ret = it->second.value().call(std::move(args));
-            it->second.unref();
-            return ret;
+            return it->second.value()(args...);
         } else {
             throw std::runtime_error("Function not found");
         }
@@ -505,6 +1325,52 @@ private:
     JSFuncsMap jsFuncsMap_;
 };
 
+/**
+ * ObjectCache Native对象到JS对象的身份映射
+ * 以弱引用（引用计数为0）持有JS对象，同一个Native实体在其JS对象存活期间总是返回同一个JS对象，
+ * JS对象被回收后由挂在其上的finalizer自动清除对应的条目。
+ * @note 一个ObjectCache只应在一个napi_env中使用，其他env中的条目视为不存在
+ */
+template <typename Key, typename Hash = std::hash<Key>> class ObjectCache {
+    struct Entry {
+        napi_env env;
+        Reference<Object> ref;
+        std::uint64_t token; // 用于区分同一个key先后插入的不同JS对象
+    };
+    struct State {
+        std::mutex mtx;
+        std::unordered_map<Key, Entry, Hash> entries;
+        std::uint64_t nextToken = 0;
+    };
+    struct FinalizeHint {
+        std::weak_ptr<State> state;
+        Key key;
+        std::uint64_t token;
+    };
+
+public:
+    ObjectCache() : state_(std::make_shared<State>()) {}
+
+    ObjectCache(const ObjectCache &) = delete;
+    ObjectCache &operator=(const ObjectCache &) = delete;
+
+    /// 查找key对应的仍存活的JS对象，不存在时返回空的Object（isEmpty()为true）
+    Object find(napi_env env, const Key &key) const;
+    /// 建立key到object的映射，替换已有的映射
+    void insert(const Key &key, const Object &object);
+    /// 命中时直接返回缓存的JS对象，否则调用factory()创建并缓存
+    template <typename Factory> Object getOrCreate(napi_env env, const Key &key, Factory factory);
+    void erase(const Key &key);
+    /// 释放所有条目持有的napi_ref，需在JS线程中调用
+    void clear();
+    std::size_t size() const;
+
+private:
+    static void OnFinalize(napi_env env, void *data, void *hint);
+
+    std::shared_ptr<State> state_;
+};
+
 } // namespace tools
 
 } // namespace napi
@@ -516,11 +1382,14 @@ private:
 #define APPEND_AKI_SYMBOLS(env, exports)
 #endif
 
-#define NAPI_FUNC(name, argc, body)                                                                                    \
+// body以可变参数接收，因此其中可以直接出现逗号（如std::map<std::string, int>）
+#define NAPI_FUNC(name, argc, ...)                                                                                     \
     static napi_value napi__##name(napi_env environment, napi_callback_info information) {                             \
+        OHOS::napi::tools::CallArena::Scope arenaScope;                                                                \
+        OHOS::napi::details::HotValueScope hotValueScope;                                                              \
         OHOS::napi::Env env(environment);                                                                              \
         OHOS::napi::CallbackInfo cbInfo(environment, information, argc);                                               \
-        body;                                                                                                          \
+        __VA_ARGS__;                                                                                                   \
     }
 
 #define NAPI_BIND_FUNC(utf8name, name, method, getter, setter, value, attributes, data)                                \
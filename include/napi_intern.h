@@ -0,0 +1,242 @@
+#ifndef OHOS_NAPI_INTERN_H
+#define OHOS_NAPI_INTERN_H
+
+#include "napi_framework.h"
+
+#include <list>
+
+namespace OHOS {
+namespace napi {
+namespace tools {
+
+/**
+ * StringTable<N> 编译期已知的名称表（枚举名、状态码、列名等）
+ * 每个名称在每个env中只创建一次JS字符串，之后按下标取回，不再重复UTF-8解码与分配。
+ * napi_create_reference接受字符串时（HarmonyOS的NAPI，或模块以Node-API 10及以上版本加载）每个名称持有一个napi_ref，
+ * 命中只需一次napi_get_reference_value；否则存放在该表独占的JS数组中（整个表一个napi_ref）。
+ *   enum class State { Idle, Running, Done };
+ *   static const tools::StringTable kStateNames("idle", "running", "done");
+ *   return kStateNames.get(env, state);
+ * @note 表须在使用它的env存续期间保持存活（通常为静态对象），名称指向的字符串同样如此
+ */
+template <std::size_t N> class StringTable {
+public:
+    template <typename... Names, typename = std::enable_if_t<sizeof...(Names) == N>>
+    constexpr explicit StringTable(Names... names) : names_{std::string_view(names)...} {}
+
+    static constexpr std::size_t size() { return N; }
+    constexpr std::string_view name(std::size_t index) const { return names_.at(index); }
+    /// name的下标，不存在时返回N
+    constexpr std::size_t indexOf(std::string_view name) const;
+
+    /// 下标越界时抛出std::out_of_range
+    String get(napi_env env, std::size_t index) const;
+    /// 以枚举值的底层值作为下标
+    template <typename E, typename = std::enable_if_t<std::is_enum<E>::value>> String get(napi_env env, E value) const {
+        return get(env, static_cast<std::size_t>(value));
+    }
+
+private:
+    std::array<std::string_view, N> names_;
+};
+
+template <typename... Names> StringTable(Names...) -> StringTable<sizeof...(Names)>;
+
+/**
+ * StringCache 运行时取值的字符串驻留缓存，按LRU淘汰
+ * 适合取值集合较小但无法在编译期列举的字符串（标签、字段名等）：命中时只需一次散列查找与一次napi_get_reference_value。
+ * 与StringTable相同，napi_create_reference不接受字符串时改由ReferenceTable持有，命中时多一次数组元素读取。
+ * StringCache::Get(env)返回每个env一个的默认缓存，也可以按容量另建实例。
+ * @note 只能在创建它的env的JS线程上使用
+ */
+class StringCache {
+public:
+    static constexpr std::size_t kDefaultCapacity = 256;
+
+    /// env的默认缓存，容量为kDefaultCapacity
+    static StringCache &Get(napi_env env);
+
+    explicit StringCache(napi_env env, std::size_t capacity = kDefaultCapacity);
+
+    /// 取str对应的JS字符串，未命中时创建并缓存，缓存已满时淘汰最久未使用的一项
+    String get(std::string_view str);
+
+    std::size_t size() const { return lookup_.size(); }
+    std::size_t capacity() const { return capacity_; }
+    void clear();
+
+private:
+    struct Entry {
+        std::string str;
+        UniqueReference<String> ref;                              // refs_为true时
+        ReferenceTable::Handle handle = ReferenceTable::kInvalid; // 否则为strings_中的句柄
+    };
+
+    napi_env env_;
+    std::size_t capacity_;
+    bool refs_; // 每个字符串单独持有一个napi_ref
+    ReferenceTable strings_;
+    std::list<Entry> entries_; // 按最近使用排序，表头最新
+    // 键指向entries_中的字符串，节点地址稳定
+    std::unordered_map<std::string_view, std::list<Entry>::iterator> lookup_;
+};
+
+/// 在env的默认缓存中驻留str
+inline String Intern(napi_env env, std::string_view str) { return StringCache::Get(env).get(str); }
+
+/* --------------------------------- details -------------------------------- */
+
+namespace details {
+// napi_create_reference是否接受字符串：Node-API 10之前只接受对象、函数与Symbol，
+// 且Node按模块注册时声明的版本而不是头文件的NAPI_VERSION判断，所以在每个env中实际探测一次
+struct PrimitiveReferences {
+    bool supported = false;
+    bool probed = false;
+};
+
+inline bool SupportsPrimitiveReferences(napi_env env) {
+#if !defined(NAPI_FRAMEWORK_PORTABLE)
+    (void)env;
+    return true;
+#elif NAPI_VERSION < 10
+    (void)env;
+    return false;
+#else
+    auto &state = napi::details::EnvLocal<PrimitiveReferences>::Get(env);
+    if (!state.probed) {
+        napi_value probe;
+        napi_ref ref;
+        NAPI_CHECK_STATUS(env, napi_create_string_utf8(env, "", 0, &probe), "napi_create_string_utf8 failed");
+        state.supported = napi_create_reference(env, probe, 1, &ref) == napi_ok;
+        if (state.supported) {
+            napi_delete_reference(env, ref);
+        }
+        state.probed = true;
+    }
+    return state.supported;
+#endif
+}
+
+// 每个env中各StringTable已创建的字符串，按表的地址索引
+struct StringTableSlots {
+    struct Strings {
+        std::vector<UniqueReference<String>> refs; // 支持时每个名称一个napi_ref
+        UniqueReference<Array> array;              // 否则存放在数组中
+        std::vector<bool> created;
+    };
+    std::unordered_map<const void *, Strings> tables;
+};
+
+struct DefaultStringCache {
+    std::optional<StringCache> cache;
+};
+} // namespace details
+
+template <std::size_t N> constexpr std::size_t StringTable<N>::indexOf(std::string_view name) const {
+    for (std::size_t i = 0; i < N; ++i) {
+        if (names_[i] == name) {
+            return i;
+        }
+    }
+    return N;
+}
+
+template <std::size_t N> inline String StringTable<N>::get(napi_env env, std::size_t index) const {
+    if (index >= N) {
+        throw std::out_of_range("String table index out of range");
+    }
+    auto &strings = napi::details::EnvLocal<details::StringTableSlots>::Get(env).tables[this];
+    if (strings.created.empty()) {
+        strings.created.resize(N);
+        if (details::SupportsPrimitiveReferences(env)) {
+            strings.refs.resize(N);
+        } else {
+            strings.array = UniqueReference<Array>::Create(Array::Create(env, N), 1);
+        }
+    }
+    napi_value result;
+    if (strings.created[index]) {
+        if (!strings.refs.empty()) {
+            return strings.refs[index].value();
+        }
+        NAPI_CHECK_STATUS(env,
+                          napi_get_element(env, strings.array.value(), static_cast<std::uint32_t>(index), &result),
+                          "napi_get_element failed");
+        return String(env, result);
+    }
+    NAPI_CHECK_STATUS(env, napi_create_string_utf8(env, names_[index].data(), names_[index].size(), &result),
+                      "napi_create_string_utf8 failed");
+    if (!strings.refs.empty()) {
+        strings.refs[index] = UniqueReference<String>::Create(String(env, result), 1);
+    } else {
+        NAPI_CHECK_STATUS(env,
+                          napi_set_element(env, strings.array.value(), static_cast<std::uint32_t>(index), result),
+                          "napi_set_element failed");
+    }
+    strings.created[index] = true;
+    return String(env, result);
+}
+
+inline StringCache &StringCache::Get(napi_env env) {
+    auto &holder = napi::details::EnvLocal<details::DefaultStringCache>::Get(env);
+    if (!holder.cache) {
+        holder.cache.emplace(env);
+    }
+    return *holder.cache;
+}
+
+inline StringCache::StringCache(napi_env env, std::size_t capacity)
+    : env_(env), capacity_(capacity), refs_(details::SupportsPrimitiveReferences(env)), strings_(env) {
+    if (capacity_ == 0) {
+        throw std::invalid_argument("StringCache capacity must be positive");
+    }
+    lookup_.reserve(capacity_);
+}
+
+inline String StringCache::get(std::string_view str) {
+    auto it = lookup_.find(str);
+    if (it != lookup_.end()) {
+        if (it->second != entries_.begin()) {
+            entries_.splice(entries_.begin(), entries_, it->second);
+        }
+        const Entry &entry = *it->second;
+        return refs_ ? entry.ref.value() : String(env_, strings_.get(entry.handle));
+    }
+    String result = String::Create(env_, str.data(), str.size());
+    // 先持有新字符串再改动节点：NAPI调用失败抛出异常时缓存保持原样
+    UniqueReference<String> ref;
+    ReferenceTable::Handle handle = ReferenceTable::kInvalid;
+    if (refs_) {
+        ref = UniqueReference<String>::Create(result, 1);
+    } else {
+        handle = strings_.add(result);
+    }
+    if (lookup_.size() == capacity_) {
+        // 复用最久未使用一项的节点，避免一次释放与分配；移动赋值同时释放被淘汰字符串的napi_ref
+        auto last = std::prev(entries_.end());
+        if (!refs_) {
+            strings_.release(last->handle);
+        }
+        lookup_.erase(last->str);
+        entries_.splice(entries_.begin(), entries_, last);
+        entries_.front().str.assign(str.data(), str.size());
+        entries_.front().ref = std::move(ref);
+        entries_.front().handle = handle;
+    } else {
+        entries_.push_front(Entry{std::string(str), std::move(ref), handle});
+    }
+    lookup_.emplace(entries_.front().str, entries_.begin());
+    return result;
+}
+
+inline void StringCache::clear() {
+    lookup_.clear();
+    entries_.clear();
+    strings_.clear();
+}
+
+} // namespace tools
+} // namespace napi
+} // namespace OHOS
+
+#endif // OHOS_NAPI_INTERN_H
@@ -0,0 +1,807 @@
+#ifndef OHOS_NAPI_JSON_H
+#define OHOS_NAPI_JSON_H
+
+#include "napi_framework.h"
+
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+namespace OHOS {
+namespace napi {
+namespace json {
+
+/**
+ * Writer JSON输出缓冲区
+ * 默认把全部输出累积在内部字符串中；指定sink时为流式输出，缓冲区超过flushThreshold即交给sink，
+ * 序列化大对象时不需要在内存中保留完整的JSON文本。
+ */
+class Writer {
+public:
+    using Sink = std::function<void(std::string_view)>;
+
+    Writer() = default;
+    explicit Writer(Sink sink, std::size_t flushThreshold = 64 * 1024)
+        : sink_(std::move(sink)), flushThreshold_(flushThreshold) {
+        buffer_.reserve(flushThreshold_ + 256);
+    }
+    ~Writer() {
+        try {
+            flush();
+        } catch (...) {
+        }
+    }
+
+    Writer(const Writer &) = delete;
+    Writer &operator=(const Writer &) = delete;
+
+    void put(char c) {
+        buffer_.push_back(c);
+        maybeFlush();
+    }
+    void write(std::string_view text) {
+        buffer_.append(text.data(), text.size());
+        maybeFlush();
+    }
+    /// 按JSON字符串的规则转义后写入（不含两端的引号）
+    void writeEscaped(const char *data, std::size_t length);
+
+    /// 将缓冲区交给sink，没有sink时什么也不做
+    void flush() {
+        if (sink_ && !buffer_.empty()) {
+            sink_(buffer_);
+            buffer_.clear();
+        }
+    }
+
+    /// 没有sink时为全部输出
+    const std::string &str() const { return buffer_; }
+    std::string take() { return std::move(buffer_); }
+
+private:
+    void maybeFlush() {
+        if (sink_ && buffer_.size() >= flushThreshold_) {
+            flush();
+        }
+    }
+
+    Sink sink_;
+    std::size_t flushThreshold_ = 0;
+    std::string buffer_;
+};
+
+struct StringifyOptions {
+    std::size_t maxDepth = 128; ///< 超过该嵌套深度（通常意味着循环引用）时抛出异常
+    bool callToJSON = true;     ///< 对象有toJSON方法时以其返回值代替（如Date）
+};
+
+/**
+ * 不经过JSON.stringify直接遍历JS值并写入writer，语义与JSON.stringify一致：
+ * undefined、函数、Symbol作为属性值时跳过，作为数组元素时输出null；NaN与Infinity输出null；BigInt抛出异常。
+ * 对象的键通过一次napi_get_all_property_names取得（自有、可枚举、非Symbol）。
+ * @return value本身不可序列化（如undefined）时返回false且不写入任何内容
+ * @note toJSON调用时不传入key参数
+ */
+bool stringify(const Value &value, Writer &writer, const StringifyOptions &options = StringifyOptions());
+/// 同上，返回JSON文本，value不可序列化时返回空字符串
+std::string stringify(const Value &value, const StringifyOptions &options = StringifyOptions());
+
+/**
+ * 解析JSON文本并创建对应的JS值，同一次解析中相同的属性名只创建一次JS字符串。
+ * 文本不合法时抛出std::runtime_error，其中包含出错位置。
+ * @note 创建的句柄都位于当前handle scope中，数量与值的个数成正比
+ */
+Value parse(napi_env env, std::string_view text);
+
+/* --------------------------------- details -------------------------------- */
+
+namespace details {
+// 返回data开头无需转义的字节数
+inline std::size_t PlainPrefix(const char *data, std::size_t length) {
+    std::size_t i = 0;
+#if defined(__SSE2__)
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i control = _mm_set1_epi8(0x1F);
+    for (; i + 16 <= length; i += 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+        // 无符号比较 c <= 0x1F 等价于 max(c, 0x1F) == 0x1F
+        __m128i special = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)),
+                                       _mm_cmpeq_epi8(_mm_max_epu8(chunk, control), control));
+        int mask = _mm_movemask_epi8(special);
+        if (mask != 0) {
+            return i + static_cast<std::size_t>(__builtin_ctz(static_cast<unsigned>(mask)));
+        }
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    const uint8x16_t quote = vdupq_n_u8('"');
+    const uint8x16_t backslash = vdupq_n_u8('\\');
+    const uint8x16_t control = vdupq_n_u8(0x1F);
+    for (; i + 16 <= length; i += 16) {
+        uint8x16_t chunk = vld1q_u8(reinterpret_cast<const std::uint8_t *>(data + i));
+        uint8x16_t special =
+            vorrq_u8(vorrq_u8(vceqq_u8(chunk, quote), vceqq_u8(chunk, backslash)), vcleq_u8(chunk, control));
+        if (vmaxvq_u8(special) != 0) {
+            break; // 由下面的标量循环定位具体位置
+        }
+    }
+#endif
+    for (; i < length; ++i) {
+        auto c = static_cast<unsigned char>(data[i]);
+        if (c < 0x20 || c == '"' || c == '\\') {
+            break;
+        }
+    }
+    return i;
+}
+
+// 按ECMAScript Number::toString的规则格式化有限的double
+inline std::size_t FormatNumber(double value, char *out) {
+    if (value == 0) {
+        out[0] = '0';
+        return 1;
+    }
+    if (std::fabs(value) < 1e15 && value == std::trunc(value)) {
+        return static_cast<std::size_t>(std::to_chars(out, out + 32, static_cast<std::int64_t>(value)).ptr - out);
+    }
+    // 取最短的有效数字与十进制指数：value = 0.d1d2...dk * 10^n
+    char sci[40];
+    std::size_t sciLength;
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    sciLength = static_cast<std::size_t>(std::to_chars(sci, sci + sizeof(sci), value, std::chars_format::scientific).ptr - sci);
+#else
+    for (int precision = 15;; ++precision) {
+        sciLength = static_cast<std::size_t>(std::snprintf(sci, sizeof(sci), "%.*e", precision - 1, value));
+        if (precision == 17 || std::strtod(sci, nullptr) == value) {
+            break;
+        }
+    }
+#endif
+    std::size_t pos = 0;
+    bool negative = sci[0] == '-';
+    if (negative) {
+        ++pos;
+    }
+    char digits[20];
+    int k = 0;
+    for (; pos < sciLength && sci[pos] != 'e'; ++pos) {
+        if (sci[pos] != '.') {
+            digits[k++] = sci[pos];
+        }
+    }
+    while (k > 1 && digits[k - 1] == '0') {
+        --k;
+    }
+    int n = std::atoi(sci + pos + 1) + 1;
+
+    std::size_t len = 0;
+    if (negative) {
+        out[len++] = '-';
+    }
+    if (k <= n && n <= 21) {
+        std::memcpy(out + len, digits, k);
+        len += k;
+        std::memset(out + len, '0', n - k);
+        len += n - k;
+    } else if (0 < n && n <= 21) {
+        std::memcpy(out + len, digits, n);
+        len += n;
+        out[len++] = '.';
+        std::memcpy(out + len, digits + n, k - n);
+        len += k - n;
+    } else if (-6 < n && n <= 0) {
+        out[len++] = '0';
+        out[len++] = '.';
+        std::memset(out + len, '0', -n);
+        len += -n;
+        std::memcpy(out + len, digits, k);
+        len += k;
+    } else {
+        out[len++] = digits[0];
+        if (k > 1) {
+            out[len++] = '.';
+            std::memcpy(out + len, digits + 1, k - 1);
+            len += k - 1;
+        }
+        out[len++] = 'e';
+        out[len++] = n - 1 >= 0 ? '+' : '-';
+        len += static_cast<std::size_t>(std::to_chars(out + len, out + len + 8, std::abs(n - 1)).ptr - (out + len));
+    }
+    return len;
+}
+
+class Stringifier {
+public:
+    Stringifier(napi_env env, Writer &writer, const StringifyOptions &options)
+        : env_(env), writer_(writer), options_(options) {}
+
+    bool run(napi_value value) {
+        // 在最外层的handle scope中创建，容器内部的scope关闭后依然有效
+        NAPI_CHECK_STATUS(env_, napi_create_string_utf8(env_, "toJSON", 6, &toJSONKey_),
+                          "napi_create_string_utf8 failed");
+        napi_valuetype type = resolve(value);
+        if (!Serializable(type)) {
+            return false;
+        }
+        write(value, type, 0);
+        return true;
+    }
+
+private:
+    static constexpr std::size_t kBatch = 1024; // 容器中每处理这么多个子元素重开一次handle scope
+
+    // 应用toJSON，value被替换为最终要序列化的值，返回其类型
+    napi_valuetype resolve(napi_value &value) {
+        napi_valuetype type = napi::details::TypeOf(env_, value);
+        if (!options_.callToJSON || type != napi_object) {
+            return type;
+        }
+        napi_value toJSON;
+        NAPI_CHECK_STATUS(env_, napi_get_property(env_, value, toJSONKey_, &toJSON), "napi_get_property failed");
+        if (napi::details::TypeOf(env_, toJSON) != napi_function) {
+            return type;
+        }
+        NAPI_CHECK_STATUS(env_, napi_call_function(env_, value, toJSON, 0, nullptr, &value),
+                          "napi_call_function failed");
+        return napi::details::TypeOf(env_, value);
+    }
+
+    static bool Serializable(napi_valuetype type) {
+        return type != napi_undefined && type != napi_function && type != napi_symbol;
+    }
+
+    void write(napi_value value, napi_valuetype type, std::size_t depth) {
+        switch (type) {
+        case napi_null:
+            writer_.write("null");
+            break;
+        case napi_boolean:
+            writer_.write(Converter<bool>::FromJS(env_, value) ? "true" : "false");
+            break;
+        case napi_number: {
+            double number = Converter<double>::FromJS(env_, value);
+            if (!std::isfinite(number)) {
+                writer_.write("null");
+            } else {
+                char buffer[40];
+                writer_.write(std::string_view(buffer, FormatNumber(number, buffer)));
+            }
+            break;
+        }
+        case napi_string:
+            writeString(value);
+            break;
+        case napi_bigint:
+            throw std::runtime_error("Do not know how to serialize a BigInt");
+        case napi_object:
+            if (depth >= options_.maxDepth) {
+                throw std::runtime_error("JSON nesting too deep or cyclic structure");
+            }
+            if (napi::details::IsArray(env_, value)) {
+                writeArray(value, depth + 1);
+            } else {
+                writeObject(value, depth + 1);
+            }
+            break;
+        default:
+            writer_.write("{}");
+            break;
+        }
+    }
+
+    void writeString(napi_value value) {
+        // 先按现有缓冲区读取，可能被截断时再查询实际长度，短字符串只需一次调用
+        if (scratch_.size() < 256) {
+            scratch_.resize(256);
+        }
+        std::size_t length;
+        NAPI_CHECK_STATUS(env_, napi_get_value_string_utf8(env_, value, &scratch_[0], scratch_.size(), &length),
+                          "napi_get_value_string_utf8 failed");
+        if (length + 4 >= scratch_.size()) {
+            NAPI_CHECK_STATUS(env_, napi_get_value_string_utf8(env_, value, nullptr, 0, &length),
+                              "napi_get_value_string_utf8 failed");
+            scratch_.resize(length + 1);
+            NAPI_CHECK_STATUS(env_, napi_get_value_string_utf8(env_, value, &scratch_[0], length + 1, &length),
+                              "napi_get_value_string_utf8 failed");
+        }
+        writer_.put('"');
+        writer_.writeEscaped(scratch_.data(), length);
+        writer_.put('"');
+    }
+
+    void writeArray(napi_value array, std::size_t depth) {
+        std::uint32_t length;
+        NAPI_CHECK_STATUS(env_, napi_get_array_length(env_, array, &length), "napi_get_array_length failed");
+        writer_.put('[');
+        std::optional<tools::HandleScope> scope;
+        for (std::uint32_t i = 0; i < length; ++i) {
+            if (i % kBatch == 0) {
+                scope.reset();
+                scope.emplace(env_);
+            }
+            if (i > 0) {
+                writer_.put(',');
+            }
+            napi_value element;
+            NAPI_CHECK_STATUS(env_, napi_get_element(env_, array, i, &element), "napi_get_element failed");
+            napi_valuetype type = resolve(element);
+            if (Serializable(type)) {
+                write(element, type, depth);
+            } else {
+                writer_.write("null");
+            }
+        }
+        writer_.put(']');
+    }
+
+    void writeObject(napi_value object, std::size_t depth) {
+        napi_value keys;
+        NAPI_CHECK_STATUS(env_,
+                          napi_get_all_property_names(env_, object, napi_key_own_only,
+                                                      static_cast<napi_key_filter>(napi_key_enumerable |
+                                                                                   napi_key_skip_symbols),
+                                                      napi_key_numbers_to_strings, &keys),
+                          "napi_get_all_property_names failed");
+        std::uint32_t length;
+        NAPI_CHECK_STATUS(env_, napi_get_array_length(env_, keys, &length), "napi_get_array_length failed");
+        writer_.put('{');
+        bool first = true;
+        std::optional<tools::HandleScope> scope;
+        for (std::uint32_t i = 0; i < length; ++i) {
+            if (i % kBatch == 0) {
+                scope.reset();
+                scope.emplace(env_);
+            }
+            napi_value key;
+            napi_value value;
+            NAPI_CHECK_STATUS(env_, napi_get_element(env_, keys, i, &key), "napi_get_element failed");
+            NAPI_CHECK_STATUS(env_, napi_get_property(env_, object, key, &value), "napi_get_property failed");
+            napi_valuetype type = resolve(value);
+            if (!Serializable(type)) {
+                continue;
+            }
+            if (!first) {
+                writer_.put(',');
+            }
+            first = false;
+            writeString(key);
+            writer_.put(':');
+            write(value, type, depth);
+        }
+        writer_.put('}');
+    }
+
+    napi_env env_;
+    Writer &writer_;
+    const StringifyOptions &options_;
+    napi_value toJSONKey_ = nullptr;
+    std::string scratch_;
+};
+
+class Parser {
+public:
+    Parser(napi_env env, std::string_view text) : env_(env), text_(text) {}
+
+    napi_value run() {
+        napi_value value = parseValue(0);
+        skipWhitespace();
+        if (pos_ != text_.size()) {
+            fail("unexpected trailing characters");
+        }
+        return value;
+    }
+
+private:
+    static constexpr std::size_t kMaxDepth = 512;
+
+    [[noreturn]] void fail(const char *message) const {
+        throw std::runtime_error("JSON parse error at offset " + std::to_string(pos_) + ": " + message);
+    }
+
+    void skipWhitespace() {
+        while (pos_ < text_.size()) {
+            char c = text_[pos_];
+            if (c != ' ' && c != '\t' && c != '\n' && c != '\r') {
+                break;
+            }
+            ++pos_;
+        }
+    }
+
+    bool consume(std::string_view literal) {
+        if (text_.compare(pos_, literal.size(), literal) == 0) {
+            pos_ += literal.size();
+            return true;
+        }
+        return false;
+    }
+
+    napi_value parseValue(std::size_t depth) {
+        skipWhitespace();
+        if (pos_ >= text_.size()) {
+            fail("unexpected end of input");
+        }
+        napi_value result;
+        switch (text_[pos_]) {
+        case '{':
+            return parseObject(depth + 1);
+        case '[':
+            return parseArray(depth + 1);
+        case '"': {
+            std::string_view str = parseString();
+            NAPI_CHECK_STATUS(env_, napi_create_string_utf8(env_, str.data(), str.size(), &result),
+                              "napi_create_string_utf8 failed");
+            return result;
+        }
+        case 't':
+            if (!consume("true")) {
+                fail("invalid literal");
+            }
+            NAPI_CHECK_STATUS(env_, napi_get_boolean(env_, true, &result), "napi_get_boolean failed");
+            return result;
+        case 'f':
+            if (!consume("false")) {
+                fail("invalid literal");
+            }
+            NAPI_CHECK_STATUS(env_, napi_get_boolean(env_, false, &result), "napi_get_boolean failed");
+            return result;
+        case 'n':
+            if (!consume("null")) {
+                fail("invalid literal");
+            }
+            NAPI_CHECK_STATUS(env_, napi_get_null(env_, &result), "napi_get_null failed");
+            return result;
+        default:
+            return parseNumber();
+        }
+    }
+
+    napi_value parseObject(std::size_t depth) {
+        if (depth > kMaxDepth) {
+            fail("nesting too deep");
+        }
+        ++pos_; // '{'
+        napi_value object;
+        NAPI_CHECK_STATUS(env_, napi_create_object(env_, &object), "napi_create_object failed");
+        skipWhitespace();
+        if (pos_ < text_.size() && text_[pos_] == '}') {
+            ++pos_;
+            return object;
+        }
+        for (;;) {
+            skipWhitespace();
+            if (pos_ >= text_.size() || text_[pos_] != '"') {
+                fail("expected property name");
+            }
+            std::string_view name = parseString();
+            // "__proto__"经napi_set_property会调用Object.prototype上的setter替换原型，须与JSON.parse一样定义为自有属性
+            bool proto = name == "__proto__";
+            napi_value key = internKey(name);
+            skipWhitespace();
+            if (pos_ >= text_.size() || text_[pos_] != ':') {
+                fail("expected ':'");
+            }
+            ++pos_;
+            napi_value value = parseValue(depth);
+            if (proto) {
+                napi_property_descriptor descriptor{
+                    nullptr, key, nullptr, nullptr, nullptr, value, napi_default_jsproperty, nullptr};
+                NAPI_CHECK_STATUS(env_, napi_define_properties(env_, object, 1, &descriptor),
+                                  "napi_define_properties failed");
+            } else {
+                NAPI_CHECK_STATUS(env_, napi_set_property(env_, object, key, value), "napi_set_property failed");
+            }
+            skipWhitespace();
+            if (pos_ < text_.size() && text_[pos_] == ',') {
+                ++pos_;
+                continue;
+            }
+            if (pos_ < text_.size() && text_[pos_] == '}') {
+                ++pos_;
+                return object;
+            }
+            fail("expected ',' or '}'");
+        }
+    }
+
+    napi_value parseArray(std::size_t depth) {
+        if (depth > kMaxDepth) {
+            fail("nesting too deep");
+        }
+        ++pos_; // '['
+        napi_value array;
+        NAPI_CHECK_STATUS(env_, napi_create_array(env_, &array), "napi_create_array failed");
+        skipWhitespace();
+        if (pos_ < text_.size() && text_[pos_] == ']') {
+            ++pos_;
+            return array;
+        }
+        for (std::uint32_t index = 0;; ++index) {
+            napi_value element = parseValue(depth);
+            NAPI_CHECK_STATUS(env_, napi_set_element(env_, array, index, element), "napi_set_element failed");
+            skipWhitespace();
+            if (pos_ < text_.size() && text_[pos_] == ',') {
+                ++pos_;
+                continue;
+            }
+            if (pos_ < text_.size() && text_[pos_] == ']') {
+                ++pos_;
+                return array;
+            }
+            fail("expected ',' or ']'");
+        }
+    }
+
+    napi_value parseNumber() {
+        std::size_t start = pos_;
+        bool integral = true;
+        if (pos_ < text_.size() && text_[pos_] == '-') {
+            ++pos_;
+        }
+        if (pos_ >= text_.size() || !IsDigit(text_[pos_])) {
+            fail("invalid number");
+        }
+        if (text_[pos_] == '0') {
+            ++pos_;
+        } else {
+            while (pos_ < text_.size() && IsDigit(text_[pos_])) {
+                ++pos_;
+            }
+        }
+        if (pos_ < text_.size() && text_[pos_] == '.') {
+            integral = false;
+            ++pos_;
+            if (pos_ >= text_.size() || !IsDigit(text_[pos_])) {
+                fail("invalid number");
+            }
+            while (pos_ < text_.size() && IsDigit(text_[pos_])) {
+                ++pos_;
+            }
+        }
+        if (pos_ < text_.size() && (text_[pos_] == 'e' || text_[pos_] == 'E')) {
+            integral = false;
+            ++pos_;
+            if (pos_ < text_.size() && (text_[pos_] == '+' || text_[pos_] == '-')) {
+                ++pos_;
+            }
+            if (pos_ >= text_.size() || !IsDigit(text_[pos_])) {
+                fail("invalid number");
+            }
+            while (pos_ < text_.size() && IsDigit(text_[pos_])) {
+                ++pos_;
+            }
+        }
+        const char *first = text_.data() + start;
+        const char *last = text_.data() + pos_;
+        napi_value result;
+        // 不超过15位的整数可以精确表示，直接按整数解析
+        if (integral && last - first <= 15 && !(first[0] == '-' && last - first == 2 && first[1] == '0')) {
+            std::int64_t number = 0;
+            std::from_chars(first, last, number);
+            NAPI_CHECK_STATUS(env_, napi_create_int64(env_, number, &result), "napi_create_int64 failed");
+            return result;
+        }
+        double number = 0;
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+        // 上溢、下溢（含部分实现中的次正规数）时from_chars不写入number，交给strtod得到±HUGE_VAL、0或次正规数，与JSON.parse一致
+        if (std::from_chars(first, last, number).ec != std::errc()) {
+            std::string copy(first, last);
+            number = std::strtod(copy.c_str(), nullptr);
+        }
+#else
+        std::string copy(first, last);
+        number = std::strtod(copy.c_str(), nullptr);
+#endif
+        NAPI_CHECK_STATUS(env_, napi_create_double(env_, number, &result), "napi_create_double failed");
+        return result;
+    }
+
+    // 返回解码后的字符串内容：没有转义时直接指向原文，否则指向解码缓冲区
+    std::string_view parseString() {
+        ++pos_; // '"'
+        std::size_t start = pos_;
+        std::size_t plain = PlainPrefix(text_.data() + pos_, text_.size() - pos_);
+        pos_ += plain;
+        if (pos_ < text_.size() && text_[pos_] == '"') {
+            ++pos_;
+            return text_.substr(start, plain);
+        }
+        decoded_.assign(text_.data() + start, plain);
+        while (pos_ < text_.size()) {
+            char c = text_[pos_++];
+            if (c == '"') {
+                return decoded_;
+            }
+            if (static_cast<unsigned char>(c) < 0x20) {
+                fail("control character in string");
+            }
+            if (c != '\\') {
+                decoded_.push_back(c);
+                continue;
+            }
+            if (pos_ >= text_.size()) {
+                break;
+            }
+            switch (text_[pos_++]) {
+            case '"':
+                decoded_.push_back('"');
+                break;
+            case '\\':
+                decoded_.push_back('\\');
+                break;
+            case '/':
+                decoded_.push_back('/');
+                break;
+            case 'b':
+                decoded_.push_back('\b');
+                break;
+            case 'f':
+                decoded_.push_back('\f');
+                break;
+            case 'n':
+                decoded_.push_back('\n');
+                break;
+            case 'r':
+                decoded_.push_back('\r');
+                break;
+            case 't':
+                decoded_.push_back('\t');
+                break;
+            case 'u': {
+                std::uint32_t code = parseHex4();
+                if (code >= 0xD800 && code <= 0xDBFF && text_.compare(pos_, 2, "\\u") == 0) {
+                    std::size_t saved = pos_;
+                    pos_ += 2;
+                    std::uint32_t low = parseHex4();
+                    if (low >= 0xDC00 && low <= 0xDFFF) {
+                        code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                    } else {
+                        pos_ = saved;
+                    }
+                }
+                AppendUtf8(decoded_, code);
+                break;
+            }
+            default:
+                fail("invalid escape");
+            }
+        }
+        fail("unterminated string");
+    }
+
+    std::uint32_t parseHex4() {
+        if (pos_ + 4 > text_.size()) {
+            fail("invalid unicode escape");
+        }
+        std::uint32_t code = 0;
+        for (int i = 0; i < 4; ++i) {
+            char c = text_[pos_++];
+            code <<= 4;
+            if (c >= '0' && c <= '9') {
+                code |= c - '0';
+            } else if (c >= 'a' && c <= 'f') {
+                code |= c - 'a' + 10;
+            } else if (c >= 'A' && c <= 'F') {
+                code |= c - 'A' + 10;
+            } else {
+                fail("invalid unicode escape");
+            }
+        }
+        return code;
+    }
+
+    static void AppendUtf8(std::string &out, std::uint32_t code) {
+        if (code < 0x80) {
+            out.push_back(static_cast<char>(code));
+        } else if (code < 0x800) {
+            out.push_back(static_cast<char>(0xC0 | (code >> 6)));
+            out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        } else if (code < 0x10000) {
+            out.push_back(static_cast<char>(0xE0 | (code >> 12)));
+            out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        } else {
+            out.push_back(static_cast<char>(0xF0 | (code >> 18)));
+            out.push_back(static_cast<char>(0x80 | ((code >> 12) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        }
+    }
+
+    static bool IsDigit(char c) { return c >= '0' && c <= '9'; }
+
+    // 同一次解析中相同的属性名复用同一个JS字符串
+    napi_value internKey(std::string_view key) {
+        auto it = keys_.find(key);
+        if (it != keys_.end()) {
+            return it->second;
+        }
+        // 解码得到的键需要自行保存，原文中的键直接引用原文
+        if (key.data() == decoded_.data()) {
+            key = keyStorage_.emplace_back(key);
+        }
+        napi_value value;
+        NAPI_CHECK_STATUS(env_, napi_create_string_utf8(env_, key.data(), key.size(), &value),
+                          "napi_create_string_utf8 failed");
+        keys_.emplace(key, value);
+        return value;
+    }
+
+    napi_env env_;
+    std::string_view text_;
+    std::size_t pos_ = 0;
+    std::string decoded_;
+    std::unordered_map<std::string_view, napi_value> keys_;
+    std::deque<std::string> keyStorage_;
+};
+} // namespace details
+
+inline void Writer::writeEscaped(const char *data, std::size_t length) {
+    static constexpr char kHex[] = "0123456789abcdef";
+    std::size_t pos = 0;
+    while (pos < length) {
+        std::size_t plain = details::PlainPrefix(data + pos, length - pos);
+        buffer_.append(data + pos, plain);
+        pos += plain;
+        if (pos >= length) {
+            break;
+        }
+        char c = data[pos++];
+        switch (c) {
+        case '"':
+            buffer_.append("\\\"", 2);
+            break;
+        case '\\':
+            buffer_.append("\\\\", 2);
+            break;
+        case '\b':
+            buffer_.append("\\b", 2);
+            break;
+        case '\f':
+            buffer_.append("\\f", 2);
+            break;
+        case '\n':
+            buffer_.append("\\n", 2);
+            break;
+        case '\r':
+            buffer_.append("\\r", 2);
+            break;
+        case '\t':
+            buffer_.append("\\t", 2);
+            break;
+        default: {
+            char escaped[6] = {'\\', 'u', '0', '0', kHex[(c >> 4) & 0xF], kHex[c & 0xF]};
+            buffer_.append(escaped, sizeof(escaped));
+            break;
+        }
+        }
+    }
+    maybeFlush();
+}
+
+inline bool stringify(const Value &value, Writer &writer, const StringifyOptions &options) {
+    tools::HandleScope scope(value.env());
+    return details::Stringifier(value.env(), writer, options).run(value);
+}
+
+inline std::string stringify(const Value &value, const StringifyOptions &options) {
+    Writer writer;
+    stringify(value, writer, options);
+    return writer.take();
+}
+
+inline Value parse(napi_env env, std::string_view text) { return Value(env, details::Parser(env, text).run()); }
+
+} // namespace json
+} // namespace napi
+} // namespace OHOS
+
+#endif // OHOS_NAPI_JSON_H
@@ -0,0 +1,338 @@
+#ifndef OHOS_NAPI_LAZY_H
+#define OHOS_NAPI_LAZY_H
+
+#include "napi_framework.h"
+
+#include <deque>
+
+namespace OHOS {
+namespace napi {
+namespace lazy {
+
+/**
+ * Schema<T> 把Native结构体按需暴露给JS的访问器描述
+ * 每个字段对应类原型上的一个getter（napi_define_class），JS读取字段时才从Native对象转换，
+ * 未被读取的字段不产生任何开销。字符串、数组、嵌套结构体等非基本类型的字段首次读取后
+ * 作为自有属性缓存在对象上，之后的读取不再进入Native。
+ *   static const lazy::Schema<Record> kRecord = lazy::Schema<Record>("Record")
+ *       .field("id", &Record::id)
+ *       .field("tags", &Record::tags)
+ *       .nested("owner", &Record::owner, kUser)
+ *       .array("items", &Record::items, kItem);
+ *   return kRecord.create(env, std::move(record));
+ * 嵌套结构体与结构体数组的元素同样是访问器对象，通过shared_ptr的别名构造共享外层对象，不发生拷贝。
+ * 原型上提供toJSON，JSON.stringify时转换全部字段。
+ * 实例以Schema<T>的类型标记标记，getter与toJSON被call到其他对象上时抛出TypeError，不会误解包。
+ * @note Schema须在使用它的env存续期间保持存活（通常为静态对象），且在首次create之后不能再添加字段。
+ *       每个env中的类按Schema的地址缓存，移动构造只用于上面的构建链，首次create之后不能再移动
+ */
+template <typename T> class Schema {
+public:
+    explicit Schema(std::string className) : className_(std::move(className)) {}
+
+    Schema(const Schema &) = delete;
+    Schema &operator=(const Schema &) = delete;
+    Schema(Schema &&) = default;
+    Schema &operator=(Schema &&) = delete;
+
+    /// 通过Converter<M>转换的字段
+    template <typename M> Schema &field(const char *name, M T::*member) &;
+    /// 由fn(const T &)计算的只读字段，结果通过Converter转换
+    template <typename F> Schema &computed(const char *name, F fn) &;
+    /// 嵌套结构体，转换为schema描述的访问器对象
+    template <typename U> Schema &nested(const char *name, U T::*member, const Schema<U> &schema) &;
+    /// 同上，空指针转换为null
+    template <typename U>
+    Schema &nested(const char *name, std::shared_ptr<U> T::*member, const Schema<std::remove_const_t<U>> &schema) &;
+    /// 结构体数组，转换为由访问器对象组成的JS数组
+    template <typename U, typename Alloc>
+    Schema &array(const char *name, std::vector<U, Alloc> T::*member, const Schema<U> &schema) &;
+
+    // 临时对象上的构建链，结果可以直接初始化静态对象
+    template <typename M> Schema &&field(const char *name, M T::*member) && {
+        return std::move(field(name, member));
+    }
+    template <typename F> Schema &&computed(const char *name, F fn) && {
+        return std::move(computed(name, std::move(fn)));
+    }
+    template <typename U> Schema &&nested(const char *name, U T::*member, const Schema<U> &schema) && {
+        return std::move(nested(name, member, schema));
+    }
+    template <typename U>
+    Schema &&nested(const char *name, std::shared_ptr<U> T::*member,
+                    const Schema<std::remove_const_t<U>> &schema) && {
+        return std::move(nested(name, member, schema));
+    }
+    template <typename U, typename Alloc>
+    Schema &&array(const char *name, std::vector<U, Alloc> T::*member, const Schema<U> &schema) && {
+        return std::move(array(name, member, schema));
+    }
+
+    /// 创建访问器对象，object由返回的JS对象及其嵌套的访问器对象共同持有。
+    /// byteLength计入tools::MemoryAccounting（类别"lazy"）
+    Object create(napi_env env, std::shared_ptr<const T> object, std::size_t byteLength = sizeof(T)) const;
+    Object create(napi_env env, T &&object) const;
+
+private:
+    using Getter = std::function<napi_value(napi_env, const std::shared_ptr<const T> &)>;
+
+    struct Entry {
+        std::string name;
+        Getter get;
+        bool cache; // 首次读取后缓存为自有属性
+    };
+    struct Box {
+        std::shared_ptr<const T> object;
+    };
+    // create传给构造回调的对象，构造回调取走后置空
+    struct Pending {
+        Box *box = nullptr;
+        std::size_t byteLength = 0;
+    };
+
+    template <typename M> static constexpr bool Cacheable() {
+        return !std::is_arithmetic<M>::value && !std::is_enum<M>::value;
+    }
+
+    Schema &add(const char *name, Getter get, bool cache);
+    Function constructor(napi_env env) const;
+
+    static Pending &CurrentPending();
+    static napi_value Construct(napi_env env, napi_callback_info info);
+    static napi_value Get(napi_env env, napi_callback_info info);
+    static napi_value ToJSON(napi_env env, napi_callback_info info);
+    // self不是本Schema<T>创建的实例时返回nullptr
+    static Box *Unwrap(napi_env env, napi_value self);
+
+    std::string className_;
+    std::deque<Entry> entries_; // 元素地址作为getter的data，须保持稳定
+};
+
+/* --------------------------------- details -------------------------------- */
+
+namespace details {
+// 每个env中各Schema定义的类
+struct SchemaClasses {
+    std::unordered_map<const void *, tools::UniqueReference<Function>> classes;
+};
+} // namespace details
+
+template <typename T> template <typename M> inline Schema<T> &Schema<T>::field(const char *name, M T::*member) & {
+    return add(
+        name,
+        [member](napi_env env, const std::shared_ptr<const T> &object) {
+            return Converter<M>::ToJS(env, (*object).*member);
+        },
+        Cacheable<M>());
+}
+
+template <typename T> template <typename F> inline Schema<T> &Schema<T>::computed(const char *name, F fn) & {
+    using R = std::decay_t<decltype(fn(std::declval<const T &>()))>;
+    return add(
+        name,
+        [fn = std::move(fn)](napi_env env, const std::shared_ptr<const T> &object) {
+            return Converter<R>::ToJS(env, fn(*object));
+        },
+        Cacheable<R>());
+}
+
+template <typename T>
+template <typename U>
+inline Schema<T> &Schema<T>::nested(const char *name, U T::*member, const Schema<U> &schema) & {
+    return add(
+        name,
+        [member, &schema](napi_env env, const std::shared_ptr<const T> &object) -> napi_value {
+            // 别名构造：共享外层对象的所有权，指向其成员
+            return schema.create(env, std::shared_ptr<const U>(object, &((*object).*member)), 0);
+        },
+        true);
+}
+
+template <typename T>
+template <typename U>
+inline Schema<T> &Schema<T>::nested(const char *name, std::shared_ptr<U> T::*member,
+                                    const Schema<std::remove_const_t<U>> &schema) & {
+    return add(
+        name,
+        [member, &schema](napi_env env, const std::shared_ptr<const T> &object) -> napi_value {
+            const std::shared_ptr<U> &child = (*object).*member;
+            if (child == nullptr) {
+                return Env(env).null();
+            }
+            return schema.create(env, child, 0);
+        },
+        true);
+}
+
+template <typename T>
+template <typename U, typename Alloc>
+inline Schema<T> &Schema<T>::array(const char *name, std::vector<U, Alloc> T::*member, const Schema<U> &schema) & {
+    return add(
+        name,
+        [member, &schema](napi_env env, const std::shared_ptr<const T> &object) -> napi_value {
+            const std::vector<U, Alloc> &items = (*object).*member;
+            napi_value result;
+            NAPI_CHECK_STATUS(env, napi_create_array_with_length(env, items.size(), &result),
+                              "Create array failed");
+            for (std::size_t i = 0; i < items.size(); ++i) {
+                tools::HandleScope scope(env);
+                Object item = schema.create(env, std::shared_ptr<const U>(object, &items[i]), 0);
+                NAPI_CHECK_STATUS(env, napi_set_element(env, result, static_cast<std::uint32_t>(i), item),
+                                  "napi_set_element failed");
+            }
+            return result;
+        },
+        true);
+}
+
+template <typename T> inline Schema<T> &Schema<T>::add(const char *name, Getter get, bool cache) {
+    entries_.push_back(Entry{name, std::move(get), cache});
+    return *this;
+}
+
+template <typename T>
+inline Object Schema<T>::create(napi_env env, std::shared_ptr<const T> object, std::size_t byteLength) const {
+    Function ctor = constructor(env);
+    Pending &pending = CurrentPending();
+    Pending saved = pending; // create可能在getter中嵌套调用
+    pending = Pending{new Box{std::move(object)}, byteLength};
+    napi_value result;
+    napi_status status = napi_new_instance(env, ctor, 0, nullptr, &result);
+    // 构造回调没有执行时由这里释放
+    delete pending.box;
+    pending = saved;
+    NAPI_CHECK_STATUS(env, status, "napi_new_instance failed");
+    return Object(env, result);
+}
+
+template <typename T> inline Object Schema<T>::create(napi_env env, T &&object) const {
+    return create(env, std::make_shared<const T>(std::move(object)));
+}
+
+template <typename T> inline Function Schema<T>::constructor(napi_env env) const {
+    auto &classes = napi::details::EnvLocal<details::SchemaClasses>::Get(env).classes;
+    auto it = classes.find(this);
+    if (it != classes.end()) {
+        return it->second.value();
+    }
+    std::vector<napi_property_descriptor> properties;
+    properties.reserve(entries_.size() + 1);
+    for (const Entry &entry : entries_) {
+        properties.push_back({entry.name.c_str(), nullptr, nullptr, Get, nullptr, nullptr, napi_enumerable,
+                              const_cast<Entry *>(&entry)});
+    }
+    properties.push_back(
+        {"toJSON", nullptr, ToJSON, nullptr, nullptr, nullptr, napi_default, const_cast<Schema *>(this)});
+    napi_value result;
+    NAPI_CHECK_STATUS(env,
+                      napi_define_class(env, className_.c_str(), className_.size(), Construct, nullptr,
+                                        properties.size(), properties.data(), &result),
+                      "napi_define_class failed");
+    Function ctor(env, result);
+    classes.emplace(this, tools::UniqueReference<Function>::Create(ctor, 1));
+    return ctor;
+}
+
+template <typename T> inline typename Schema<T>::Pending &Schema<T>::CurrentPending() {
+    static thread_local Pending pending;
+    return pending;
+}
+
+template <typename T> inline napi_value Schema<T>::Construct(napi_env env, napi_callback_info info) {
+    napi::details::HotValueScope hotValueScope;
+    Pending &pending = CurrentPending();
+    if (pending.box == nullptr) {
+        napi_throw_type_error(env, nullptr, "Illegal constructor");
+        return nullptr;
+    }
+    Box *box = std::exchange(pending.box, nullptr);
+    bool wrapped = false;
+    try {
+        napi_value self;
+        NAPI_CHECK_STATUS(env, napi_get_cb_info(env, info, nullptr, nullptr, &self, nullptr),
+                          "napi_get_cb_info failed");
+        Object object(env, self);
+        object.wrap(box, pending.byteLength, "lazy");
+        wrapped = true;
+        object.brand<Box>();
+        return self;
+    } catch (const std::exception &e) {
+        napi_throw_error(env, nullptr, e.what());
+    } catch (...) {
+        napi_throw_error(env, nullptr, "unknown native exception");
+    }
+    if (!wrapped) {
+        delete box;
+    }
+    return nullptr;
+}
+
+template <typename T> inline typename Schema<T>::Box *Schema<T>::Unwrap(napi_env env, napi_value self) {
+    Object object(env, self);
+    // 其他Schema或其他模块wrap的对象同样能unwrap出指针，须先检查类型标记（不是对象时为false）
+    return object.isBranded<Box>() ? object.unwrap<Box>() : nullptr;
+}
+
+template <typename T> inline napi_value Schema<T>::Get(napi_env env, napi_callback_info info) {
+    napi::details::HotValueScope hotValueScope;
+    try {
+        napi_value self;
+        void *data;
+        NAPI_CHECK_STATUS(env, napi_get_cb_info(env, info, nullptr, nullptr, &self, &data),
+                          "napi_get_cb_info failed");
+        const auto *entry = static_cast<const Entry *>(data);
+        Box *box = Unwrap(env, self);
+        if (box == nullptr) {
+            napi_throw_type_error(env, nullptr, "Illegal invocation");
+            return nullptr;
+        }
+        napi_value value = entry->get(env, box->object);
+        if (entry->cache) {
+            // 自有数据属性遮蔽原型上的getter，之后的读取不再进入Native
+            napi_property_descriptor descriptor{entry->name.c_str(), nullptr, nullptr, nullptr,
+                                                nullptr,             value,   napi_enumerable, nullptr};
+            NAPI_CHECK_STATUS(env, napi_define_properties(env, self, 1, &descriptor), "napi_define_properties failed");
+        }
+        return value;
+    } catch (const std::exception &e) {
+        napi_throw_error(env, nullptr, e.what());
+    } catch (...) {
+        napi_throw_error(env, nullptr, "unknown native exception");
+    }
+    return nullptr;
+}
+
+template <typename T> inline napi_value Schema<T>::ToJSON(napi_env env, napi_callback_info info) {
+    napi::details::HotValueScope hotValueScope;
+    try {
+        napi_value self;
+        void *data;
+        NAPI_CHECK_STATUS(env, napi_get_cb_info(env, info, nullptr, nullptr, &self, &data),
+                          "napi_get_cb_info failed");
+        const auto *schema = static_cast<const Schema *>(data);
+        Box *box = Unwrap(env, self);
+        if (box == nullptr) {
+            napi_throw_type_error(env, nullptr, "Illegal invocation");
+            return nullptr;
+        }
+        // 嵌套的访问器对象由JSON.stringify继续调用其toJSON
+        Object result = Object::Create(env);
+        for (const Entry &entry : schema->entries_) {
+            NAPI_CHECK_STATUS(env,
+                              napi_set_named_property(env, result, entry.name.c_str(), entry.get(env, box->object)),
+                              "napi_set_named_property failed");
+        }
+        return result;
+    } catch (const std::exception &e) {
+        napi_throw_error(env, nullptr, e.what());
+    } catch (...) {
+        napi_throw_error(env, nullptr, "unknown native exception");
+    }
+    return nullptr;
+}
+
+} // namespace lazy
+} // namespace napi
+} // namespace OHOS
+
+#endif // OHOS_NAPI_LAZY_H
@@ -0,0 +1,401 @@
+#ifndef OHOS_NAPI_PARALLEL_H
+#define OHOS_NAPI_PARALLEL_H
+
+#include "napi_framework.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <optional>
+#include <string>
+#include <thread>
+
+namespace OHOS {
+namespace napi {
+namespace parallel {
+
+/**
+ * ThreadPool 工作窃取线程池
+ * 每个工作线程有自己的任务队列，从队尾取自己提交的任务，空闲时从其他线程的队首窃取。
+ * 提交任务的线程在parallelFor中也会参与执行，不会空等。
+ */
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    /// 全局线程池，工作线程数为CPU核数减一（调用线程也会参与计算）
+    static ThreadPool &Instance();
+
+    explicit ThreadPool(std::size_t threadCount);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    std::size_t size() const { return threads_.size(); }
+
+    void submit(Task task);
+    /// 将[0, count)按grain切分为若干块，并行执行fn(begin, end)，全部完成后返回。
+    /// 任意一块抛出的异常会在所有块结束后重新抛出。
+    template <typename Fn> void parallelFor(std::size_t count, std::size_t grain, Fn &&fn);
+
+private:
+    struct Queue {
+        std::mutex mtx;
+        std::deque<Task> tasks;
+    };
+
+    static constexpr std::size_t kNotWorker = static_cast<std::size_t>(-1);
+    static std::size_t &CurrentWorker();
+
+    bool tryRunOne(std::size_t self);
+    void workerLoop(std::size_t index);
+
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> threads_;
+    std::mutex sleepMtx_;
+    std::condition_variable sleepCv_;
+    std::atomic<std::size_t> pending_{0};
+    std::atomic<std::size_t> nextQueue_{0};
+    bool stop_ = false;
+};
+
+struct Options {
+    /// 元素个数达到该值时在线程池中异步执行并返回Promise，否则在JS线程中同步执行并直接返回结果
+    std::size_t asyncThreshold = 256 * 1024;
+    /// 每个任务块的元素个数
+    std::size_t grain = 32 * 1024;
+};
+
+/**
+ * 对TypedArray的每个元素执行fn，fn的签名为`void(T &element)`或按块处理的`void(T *begin, T *end)`。
+ * 小数组同步执行并返回undefined；大数组在线程池中并行执行并返回Promise<undefined>。
+ * 元素的数据指针在JS线程上取得，工作线程只访问原始内存，执行期间持有对该TypedArray的引用以防止被回收。
+ * @note 异步执行期间JS侧不应修改或转移（transfer）该数组。
+ */
+template <typename T, typename Fn>
+Value forEach(napi_env env, const TypedArrayOf<T> &array, Fn fn, const Options &options = Options());
+
+/**
+ * 并行归约：每块以identity为初值依次执行`acc = op(acc, element)`，再以`combine(acc, acc)`合并各块结果。
+ * 结果通过Converter<R>转换为JS值；小数组同步返回结果，大数组返回Promise。
+ */
+template <typename T, typename R, typename Op, typename Combine>
+Value reduce(napi_env env, const TypedArrayOf<T> &array, R identity, Op op, Combine combine,
+             const Options &options = Options());
+/// 同上，op同时用于合并各块结果（如求和、求最大值）
+template <typename T, typename R, typename Op>
+Value reduce(napi_env env, const TypedArrayOf<T> &array, R identity, Op op, const Options &options = Options());
+
+/* --------------------------------- details -------------------------------- */
+
+inline ThreadPool &ThreadPool::Instance() {
+    static ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()) - 1);
+    return pool;
+}
+
+inline std::size_t &ThreadPool::CurrentWorker() {
+    static thread_local std::size_t index = kNotWorker;
+    return index;
+}
+
+inline ThreadPool::ThreadPool(std::size_t threadCount) {
+    for (std::size_t i = 0; i < threadCount; ++i) {
+        queues_.emplace_back(std::make_unique<Queue>());
+    }
+    for (std::size_t i = 0; i < threadCount; ++i) {
+        threads_.emplace_back([this, i] { workerLoop(i); });
+    }
+}
+
+inline ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lck(sleepMtx_);
+        stop_ = true;
+    }
+    sleepCv_.notify_all();
+    for (auto &thread : threads_) {
+        thread.join();
+    }
+}
+
+inline void ThreadPool::submit(Task task) {
+    if (queues_.empty()) {
+        task();
+        return;
+    }
+    std::size_t self = CurrentWorker();
+    std::size_t index = self != kNotWorker ? self : nextQueue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+    {
+        std::lock_guard<std::mutex> lck(queues_[index]->mtx);
+        queues_[index]->tasks.push_back(std::move(task));
+    }
+    pending_.fetch_add(1, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lck(sleepMtx_);
+    }
+    sleepCv_.notify_one();
+}
+
+inline bool ThreadPool::tryRunOne(std::size_t self) {
+    Task task;
+    std::size_t count = queues_.size();
+    // 先取自己的队尾，再从其他队列的队首窃取
+    for (std::size_t i = 0; i < count && !task; ++i) {
+        std::size_t index = self != kNotWorker ? (self + i) % count : i;
+        Queue &queue = *queues_[index];
+        std::lock_guard<std::mutex> lck(queue.mtx);
+        if (queue.tasks.empty()) {
+            continue;
+        }
+        if (index == self) {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+        } else {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+        }
+    }
+    if (!task) {
+        return false;
+    }
+    pending_.fetch_sub(1, std::memory_order_acq_rel);
+    task();
+    return true;
+}
+
+inline void ThreadPool::workerLoop(std::size_t index) {
+    CurrentWorker() = index;
+    for (;;) {
+        if (tryRunOne(index)) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lck(sleepMtx_);
+        sleepCv_.wait(lck, [this] { return stop_ || pending_.load(std::memory_order_acquire) > 0; });
+        if (stop_ && pending_.load(std::memory_order_acquire) == 0) {
+            return;
+        }
+    }
+}
+
+template <typename Fn> inline void ThreadPool::parallelFor(std::size_t count, std::size_t grain, Fn &&fn) {
+    grain = std::max<std::size_t>(grain, 1);
+    std::size_t chunks = (count + grain - 1) / grain;
+    if (chunks <= 1 || queues_.empty()) {
+        // 没有工作线程时在当前线程按块依次执行，保持与并行执行相同的分块方式
+        for (std::size_t begin = 0; begin < count; begin += grain) {
+            fn(begin, std::min(count, begin + grain));
+        }
+        return;
+    }
+
+    struct Batch {
+        Fn *fn;
+        std::size_t count;
+        std::size_t grain;
+        std::atomic<std::size_t> remaining;
+        std::mutex mtx;
+        std::condition_variable done;
+        std::exception_ptr error;
+    } batch{&fn, count, grain, {chunks}, {}, {}, nullptr};
+
+    for (std::size_t chunk = 0; chunk < chunks; ++chunk) {
+        submit([b = &batch, chunk] {
+            std::size_t begin = chunk * b->grain;
+            std::exception_ptr error;
+            try {
+                (*b->fn)(begin, std::min(b->count, begin + b->grain));
+            } catch (...) {
+                error = std::current_exception();
+            }
+            // 计数在锁内递减，保证等待方在最后一块释放锁之后才销毁batch
+            std::lock_guard<std::mutex> lck(b->mtx);
+            if (error) {
+                b->error = error;
+            }
+            if (b->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                b->done.notify_all();
+            }
+        });
+    }
+
+    // 调用线程参与执行，队列空了再等待其他线程完成手上的块
+    while (batch.remaining.load(std::memory_order_acquire) > 0) {
+        if (!tryRunOne(CurrentWorker())) {
+            std::unique_lock<std::mutex> lck(batch.mtx);
+            batch.done.wait_for(lck, std::chrono::milliseconds(1),
+                                [&batch] { return batch.remaining.load(std::memory_order_acquire) == 0; });
+        }
+    }
+    std::lock_guard<std::mutex> lck(batch.mtx);
+    if (batch.error) {
+        std::rethrow_exception(batch.error);
+    }
+}
+
+namespace details {
+// 在NAPI线程池中执行body，完成后在JS线程resolve Promise。执行期间持有array的引用。
+template <typename Body> class AsyncJob {
+    using Result = std::invoke_result_t<Body &>;
+
+public:
+    static Value Start(napi_env env, napi_value array, Body body) {
+        auto *job = new AsyncJob(std::move(body));
+        napi_value promise;
+        napi_value resourceName;
+        try {
+            NAPI_CHECK_STATUS(env, napi_create_promise(env, &job->deferred_, &promise), "napi_create_promise failed");
+            NAPI_CHECK_STATUS(env, napi_create_reference(env, array, 1, &job->arrayRef_),
+                              "napi_create_reference failed");
+            NAPI_CHECK_STATUS(env, napi_create_string_utf8(env, "napi_parallel", NAPI_AUTO_LENGTH, &resourceName),
+                              "napi_create_string_utf8 failed");
+            NAPI_CHECK_STATUS(env, napi_create_async_work(env, nullptr, resourceName, Execute, Complete, job, &job->work_),
+                              "napi_create_async_work failed");
+            NAPI_CHECK_STATUS(env, napi_queue_async_work(env, job->work_), "napi_queue_async_work failed");
+        } catch (...) {
+            job->release(env);
+            throw;
+        }
+        return Value(env, promise);
+    }
+
+private:
+    explicit AsyncJob(Body body) : body_(std::move(body)) {}
+
+    static void Execute(napi_env, void *data) {
+        auto *job = static_cast<AsyncJob *>(data);
+        try {
+            if constexpr (std::is_void<Result>::value) {
+                job->body_();
+            } else {
+                job->result_.emplace(job->body_());
+            }
+        } catch (...) {
+            job->error_ = std::current_exception();
+        }
+    }
+
+    static void Complete(napi_env env, napi_status status, void *data) {
+        auto *job = static_cast<AsyncJob *>(data);
+        napi_value value = nullptr;
+        bool rejected = status != napi_ok || job->error_;
+        if (rejected) {
+            std::string message = status != napi_ok ? "async work cancelled" : "native exception";
+            try {
+                if (job->error_) {
+                    std::rethrow_exception(job->error_);
+                }
+            } catch (const std::exception &e) {
+                message = e.what();
+            } catch (...) {
+            }
+            napi_value text;
+            napi_create_string_utf8(env, message.c_str(), message.size(), &text);
+            napi_create_error(env, nullptr, text, &value);
+            napi_reject_deferred(env, job->deferred_, value);
+        } else {
+            try {
+                if constexpr (std::is_void<Result>::value) {
+                    value = Env(env).undefined();
+                } else {
+                    value = Converter<Result>::ToJS(env, *job->result_);
+                }
+                napi_resolve_deferred(env, job->deferred_, value);
+            } catch (const std::exception &e) {
+                napi_value text;
+                napi_create_string_utf8(env, e.what(), NAPI_AUTO_LENGTH, &text);
+                napi_create_error(env, nullptr, text, &value);
+                napi_reject_deferred(env, job->deferred_, value);
+            }
+        }
+        job->release(env);
+    }
+
+    void release(napi_env env) {
+        if (work_ != nullptr) {
+            napi_delete_async_work(env, work_);
+        }
+        if (arrayRef_ != nullptr) {
+            napi_delete_reference(env, arrayRef_);
+        }
+        delete this;
+    }
+
+    using Storage = typename std::conditional<std::is_void<Result>::value, char, Result>::type;
+
+    Body body_;
+    napi_deferred deferred_ = nullptr;
+    napi_ref arrayRef_ = nullptr;
+    napi_async_work work_ = nullptr;
+    std::optional<Storage> result_;
+    std::exception_ptr error_;
+};
+
+template <typename Body> inline Value RunAsync(napi_env env, napi_value array, Body body) {
+    return AsyncJob<Body>::Start(env, array, std::move(body));
+}
+} // namespace details
+
+template <typename T, typename Fn>
+inline Value forEach(napi_env env, const TypedArrayOf<T> &array, Fn fn, const Options &options) {
+    T *data = array.data();
+    std::size_t length = array.length();
+    auto body = [data, length, grain = options.grain, fn = std::move(fn)]() mutable {
+        ThreadPool::Instance().parallelFor(length, grain, [data, &fn](std::size_t begin, std::size_t end) {
+            if constexpr (std::is_invocable<Fn &, T *, T *>::value) {
+                fn(data + begin, data + end);
+            } else {
+                for (std::size_t i = begin; i < end; ++i) {
+                    fn(data[i]);
+                }
+            }
+        });
+    };
+    if (length < options.asyncThreshold) {
+        body();
+        return Env(env).undefined();
+    }
+    return details::RunAsync(env, array, std::move(body));
+}
+
+template <typename T, typename R, typename Op, typename Combine>
+inline Value reduce(napi_env env, const TypedArrayOf<T> &array, R identity, Op op, Combine combine,
+                    const Options &options) {
+    const T *data = array.data();
+    std::size_t length = array.length();
+    auto body = [data, length, grain = std::max<std::size_t>(options.grain, 1), identity = std::move(identity),
+                 op = std::move(op), combine = std::move(combine)]() mutable {
+        std::vector<R> partials((length + grain - 1) / grain, identity);
+        ThreadPool::Instance().parallelFor(length, grain, [&](std::size_t begin, std::size_t end) {
+            R acc = identity;
+            for (std::size_t i = begin; i < end; ++i) {
+                acc = op(std::move(acc), data[i]);
+            }
+            partials[begin / grain] = std::move(acc);
+        });
+        R result = identity;
+        for (auto &partial : partials) {
+            result = combine(std::move(result), std::move(partial));
+        }
+        return result;
+    };
+    if (length < options.asyncThreshold) {
+        return Value::From(env, body());
+    }
+    return details::RunAsync(env, array, std::move(body));
+}
+
+template <typename T, typename R, typename Op>
+inline Value reduce(napi_env env, const TypedArrayOf<T> &array, R identity, Op op, const Options &options) {
+    return reduce(env, array, std::move(identity), op, op, options);
+}
+
+} // namespace parallel
+} // namespace napi
+} // namespace OHOS
+
+#endif // OHOS_NAPI_PARALLEL_H
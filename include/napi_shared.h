@@ -0,0 +1,265 @@
+#ifndef OHOS_NAPI_SHARED_H
+#define OHOS_NAPI_SHARED_H
+
+#include "napi_framework.h"
+
+#include <random>
+#include <typeinfo>
+
+namespace OHOS {
+namespace napi {
+namespace tools {
+
+/**
+ * SharedObject 在多个ArkTS Worker之间共享同一份Native对象
+ * Wrap把std::shared_ptr包装成可以随消息传给其他Worker的JS值，各Worker用Unwrap取回的是同一个对象（引用计数+1），
+ * 不发生拷贝，N个Worker只占一份内存。共享对象在多线程间并发访问，应当是不可变的或自行加锁。
+ * - 非PORTABLE模式：包装为Sendable对象（napi_wrap_sendable），随ArkTS的Sendable语义在Worker间按引用传递，
+ *   Sendable对象被回收时释放其持有的引用。
+ * - PORTABLE模式：在进程内的令牌表中登记，JS值为携带令牌的普通对象，可以被结构化克隆后随消息传递；
+ *   令牌在所有包装对象（包括各Worker中Unwrap过的克隆）都被回收后失效。
+ *   每个令牌附带一个随机密钥，Unwrap与Is同时核对两者，JS无法凭递增的令牌伪造出其他模块的共享对象。
+ *   @note 发送方需在接收方Unwrap之前保持包装对象存活
+ */
+class SharedObject {
+public:
+    /// byteLength为对象持有的内存大小，可以为0。非PORTABLE模式下告知GC；
+    /// PORTABLE模式下计入tools::MemoryAccounting（类别"shared"），每个持有令牌的包装对象各计一次
+    template <typename T> static Value Wrap(napi_env env, std::shared_ptr<T> object, std::size_t byteLength = 0);
+    /// 取回共享对象，T必须与Wrap时一致，否则抛出异常
+    template <typename T> static std::shared_ptr<T> Unwrap(napi_env env, const Value &value);
+    /// value是否为SharedObject::Wrap创建的值（PORTABLE模式下包括其结构化克隆，且令牌仍有效）
+    static bool Is(napi_env env, const Value &value);
+
+private:
+    // 魔数放在首个成员：非PORTABLE模式下同一env中其他模块包装的Sendable对象也能被napi_unwrap_sendable取到，
+    // 须先核对魔数再当作Box使用
+    static constexpr std::uint64_t kMagic = 0x4e41504953484152ULL; // "NAPISHAR"
+
+    struct Box {
+        std::uint64_t magic;
+        std::shared_ptr<void> object;
+        const std::type_info *type;
+    };
+
+    static Box *UnwrapBox(napi_env env, const Value &value);
+
+#ifdef NAPI_FRAMEWORK_PORTABLE
+    static constexpr const char *kTokenKey = "__napiSharedToken";
+    static constexpr const char *kSecretKey = "__napiSharedSecret";
+    static constexpr const char *kCategory = "shared";
+
+    struct Entry {
+        Box box;
+        std::uint64_t secret;
+        std::size_t holders;
+        std::size_t byteLength;
+    };
+
+    // 包装对象的finalizer上下文，持有令牌与记账
+    struct Holder {
+        std::uint64_t token;
+        Accounted accounted;
+    };
+
+    // 令牌表，进程内所有env共用
+    struct Registry {
+        std::mutex mtx;
+        std::unordered_map<std::uint64_t, Entry> entries;
+        std::uint64_t next = 1;
+        std::mt19937_64 secrets{std::random_device{}()};
+    };
+
+    static Registry &GetRegistry() {
+        static Registry registry;
+        return registry;
+    }
+
+    // 在obj上挂一个finalizer，obj被回收时令牌的持有数减一。调用方须已为obj增加持有数。
+    // 每个持有者把byteLength计入tools::MemoryAccounting（类别kCategory）
+    static void Hold(napi_env env, napi_value obj, std::uint64_t token, std::size_t byteLength);
+    static void Release(std::uint64_t token);
+    // 读取value携带的令牌与密钥，不是包装对象的形状时返回false
+    static bool ReadToken(napi_env env, const Value &value, std::uint64_t &token, std::uint64_t &secret);
+#endif
+};
+
+/* --------------------------------- details -------------------------------- */
+
+template <typename T>
+inline Value SharedObject::Wrap(napi_env env, std::shared_ptr<T> object, std::size_t byteLength) {
+    using Plain = std::remove_cv_t<T>;
+    Box box{kMagic, std::const_pointer_cast<Plain>(std::move(object)), &typeid(Plain)};
+#ifndef NAPI_FRAMEWORK_PORTABLE
+    napi_value result;
+    NAPI_CHECK_STATUS(env, napi_create_sendable_object_with_properties(env, 0, nullptr, &result),
+                      "napi_create_sendable_object_with_properties failed");
+    auto *data = new Box(std::move(box));
+    napi_status status = napi_wrap_sendable_with_size(
+        env, result, data, [](napi_env, void *data, void *) { delete static_cast<Box *>(data); }, nullptr,
+        byteLength);
+    if (status != napi_ok) {
+        delete data;
+        NAPI_CHECK_STATUS(env, status, "napi_wrap_sendable_with_size failed");
+    }
+    return Value(env, result);
+#else
+    Registry &registry = GetRegistry();
+    std::uint64_t token;
+    std::uint64_t secret;
+    {
+        std::lock_guard<std::mutex> lck(registry.mtx);
+        token = registry.next++;
+        secret = registry.secrets();
+        registry.entries.emplace(token, Entry{std::move(box), secret, 1, byteLength});
+    }
+    Object result = Object::Create(env);
+    try {
+        result.set(kTokenKey, BigInt::Create(env, token));
+        result.set(kSecretKey, BigInt::Create(env, secret));
+        Hold(env, result, token, byteLength);
+    } catch (...) {
+        std::lock_guard<std::mutex> lck(registry.mtx);
+        registry.entries.erase(token);
+        throw;
+    }
+    return result;
+#endif
+}
+
+template <typename T> inline std::shared_ptr<T> SharedObject::Unwrap(napi_env env, const Value &value) {
+    using Plain = std::remove_cv_t<T>;
+#ifndef NAPI_FRAMEWORK_PORTABLE
+    Box *box = UnwrapBox(env, value);
+    if (box == nullptr) {
+        throw std::runtime_error("Value is not a shared object");
+    }
+    if (*box->type != typeid(Plain)) {
+        throw std::runtime_error("Shared object type mismatch");
+    }
+    return std::static_pointer_cast<Plain>(box->object);
+#else
+    std::uint64_t token;
+    std::uint64_t secret;
+    if (!ReadToken(env, value, token, secret)) {
+        throw std::runtime_error("Value is not a shared object");
+    }
+    std::shared_ptr<Plain> object;
+    std::size_t byteLength;
+    Registry &registry = GetRegistry();
+    {
+        std::lock_guard<std::mutex> lck(registry.mtx);
+        auto it = registry.entries.find(token);
+        if (it == registry.entries.end()) {
+            throw std::runtime_error("Shared object token expired");
+        }
+        if (it->second.secret != secret) {
+            throw std::runtime_error("Value is not a shared object");
+        }
+        if (*it->second.box.type != typeid(Plain)) {
+            throw std::runtime_error("Shared object type mismatch");
+        }
+        object = std::static_pointer_cast<Plain>(it->second.box.object);
+        byteLength = it->second.byteLength;
+        it->second.holders++;
+    }
+    // 结构化克隆得到的对象同样持有令牌，直到它被回收
+    Hold(env, value, token, byteLength);
+    return object;
+#endif
+}
+
+inline bool SharedObject::Is(napi_env env, const Value &value) {
+#ifndef NAPI_FRAMEWORK_PORTABLE
+    return UnwrapBox(env, value) != nullptr;
+#else
+    std::uint64_t token;
+    std::uint64_t secret;
+    if (!ReadToken(env, value, token, secret)) {
+        return false;
+    }
+    Registry &registry = GetRegistry();
+    std::lock_guard<std::mutex> lck(registry.mtx);
+    auto it = registry.entries.find(token);
+    return it != registry.entries.end() && it->second.secret == secret;
+#endif
+}
+
+inline SharedObject::Box *SharedObject::UnwrapBox(napi_env env, const Value &value) {
+#ifndef NAPI_FRAMEWORK_PORTABLE
+    bool isSendable = false;
+    if (napi_is_sendable(env, value, &isSendable) != napi_ok || !isSendable) {
+        return nullptr;
+    }
+    void *data = nullptr;
+    if (napi_unwrap_sendable(env, value, &data) != napi_ok || data == nullptr) {
+        return nullptr;
+    }
+    auto *box = static_cast<Box *>(data);
+    return box->magic == kMagic ? box : nullptr;
+#else
+    (void)env;
+    (void)value;
+    return nullptr;
+#endif
+}
+
+#ifdef NAPI_FRAMEWORK_PORTABLE
+inline void SharedObject::Hold(napi_env env, napi_value obj, std::uint64_t token, std::size_t byteLength) {
+    Holder *holder;
+    try {
+        holder = new Holder{token, Accounted(env, kCategory, byteLength)};
+    } catch (...) {
+        Release(token);
+        throw;
+    }
+    napi_status status = napi_add_finalizer(
+        env, obj, holder,
+        [](napi_env, void *data, void *) {
+            auto *holder = static_cast<Holder *>(data);
+            Release(holder->token);
+            delete holder;
+        },
+        nullptr, nullptr);
+    if (status != napi_ok) {
+        Release(token);
+        delete holder;
+        NAPI_CHECK_STATUS(env, status, "napi_add_finalizer failed");
+    }
+}
+
+inline bool SharedObject::ReadToken(napi_env env, const Value &value, std::uint64_t &token, std::uint64_t &secret) {
+    if (value.type() != napi_object) {
+        return false;
+    }
+    Object obj(env, value);
+    if (!obj.hasOwnProperty(kTokenKey) || !obj.hasOwnProperty(kSecretKey)) {
+        return false;
+    }
+    Value tokenValue = obj.get(kTokenKey);
+    Value secretValue = obj.get(kSecretKey);
+    if (tokenValue.type() != napi_bigint || secretValue.type() != napi_bigint) {
+        return false;
+    }
+    token = tokenValue.as<std::uint64_t>();
+    secret = secretValue.as<std::uint64_t>();
+    return true;
+}
+
+inline void SharedObject::Release(std::uint64_t token) {
+    Registry &registry = GetRegistry();
+    std::shared_ptr<void> object; // 在锁外释放对象
+    std::lock_guard<std::mutex> lck(registry.mtx);
+    auto it = registry.entries.find(token);
+    if (it != registry.entries.end() && --it->second.holders == 0) {
+        object = std::move(it->second.box.object);
+        registry.entries.erase(it);
+    }
+}
+#endif
+
+} // namespace tools
+} // namespace napi
+} // namespace OHOS
+
+#endif // OHOS_NAPI_SHARED_H
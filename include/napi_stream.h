@@ -0,0 +1,488 @@
+#ifndef OHOS_NAPI_STREAM_H
+#define OHOS_NAPI_STREAM_H
+
+#include "napi_framework.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+
+namespace OHOS {
+namespace napi {
+
+// 缓冲区达到高水位时生产者的处理方式
+enum class Backpressure {
+    Block,      ///< 阻塞生产者直到消费者取走数据
+    DropNewest, ///< 丢弃新推入的元素
+    DropOldest, ///< 丢弃缓冲区中最早的元素
+};
+
+struct StreamOptions {
+    std::size_t highWaterMark = 4096; ///< 缓冲区最多积压的元素个数
+    std::size_t chunkSize = 1024;     ///< 每次读取最多返回的元素个数
+    Backpressure policy = Backpressure::Block;
+};
+
+/**
+ * Stream Native线程向JS推送数据的流
+ * 生产者在任意线程调用push/close，JS侧通过reader()得到的对象拉取数据：
+ * `for await (const chunk of reader)`，或手动调用`reader.next()`。
+ * 每次读取返回缓冲区中已有的一批元素（最多chunkSize个），T为算术类型时chunk为对应的TypedArray，否则为Array。
+ * 生产者只在有读取请求等待时才唤醒JS线程，且同一时刻最多排队一次唤醒，高频push不会逐个回调JS。
+ * @note 必须在JS线程上通过Create创建，一个Stream只对应一个reader。
+ */
+template <typename T> class Stream : public std::enable_shared_from_this<Stream<T>> {
+    struct Private {};
+
+public:
+    static std::shared_ptr<Stream> Create(napi_env env, const StreamOptions &options = StreamOptions());
+
+    Stream(Private, napi_env env, const StreamOptions &options);
+    Stream(const Stream &) = delete;
+    Stream &operator=(const Stream &) = delete;
+
+    /// JS侧的读取对象，只能在JS线程上调用
+    Object reader();
+
+    /// 推入一个元素，流已关闭、被取消或按DropNewest策略被丢弃时返回false。Block策略下可能阻塞。
+    bool push(const T &value);
+    bool push(T &&value);
+    /// 批量推入，返回实际写入的元素个数
+    std::size_t push(const T *values, std::size_t count);
+    /// 生产结束，JS侧读完剩余数据后迭代结束
+    void close();
+    /// 以错误结束，JS侧读完剩余数据后下一次读取被reject
+    void fail(const std::string &message);
+
+    /// 消费者是否已取消（调用了reader.return()或reader被回收），生产者应据此停止生产
+    bool cancelled() const;
+    /// 因背压被丢弃的元素个数
+    std::size_t dropped() const;
+
+private:
+    template <typename U> bool pushOne(U &&value);
+    // 须持有mtx_，有等待中的读取且尚未排队唤醒时唤醒JS线程
+    void wakeLocked();
+    // 须持有mtx_
+    void releaseLocked();
+    // 须持有mtx_，结束后没有等待中的读取时释放tsfn及其持有的Stream
+    void releaseIdleLocked();
+    void cancel();
+    void drain(napi_env env);
+    // 取出至多chunkSize个元素，调用时持有lck，正常返回时已释放：元素转换可能调用JS，期间不阻塞生产者
+    Value takeChunk(napi_env env, std::unique_lock<std::mutex> &lck);
+    Object result(napi_env env, napi_value value, bool done);
+    static void Reject(napi_env env, napi_deferred deferred, const std::string &message);
+
+    static napi_value Next(napi_env env, napi_callback_info info);
+    static napi_value Return(napi_env env, napi_callback_info info);
+    static napi_value AsyncIterator(napi_env env, napi_callback_info info);
+    static Stream *Unwrap(napi_env env, napi_callback_info info, napi_value *self = nullptr);
+
+    napi_env env_;
+    StreamOptions options_;
+    napi_threadsafe_function tsfn_ = nullptr;
+    bool hasReader_ = false;
+
+    mutable std::mutex mtx_;
+    std::condition_variable space_;
+    std::deque<T> buffer_;
+    std::deque<napi_deferred> reads_; // 等待中的读取，只在JS线程中增删
+    std::string error_;
+    std::size_t dropped_ = 0;
+    bool closed_ = false;
+    bool failed_ = false;
+    bool cancelled_ = false;
+    bool released_ = false;
+    bool wakeQueued_ = false;
+    bool loopRefed_ = true;
+};
+
+/* --------------------------------- details -------------------------------- */
+
+namespace details {
+template <typename T> struct StreamBox {
+    std::shared_ptr<Stream<T>> stream;
+};
+} // namespace details
+
+template <typename T>
+inline std::shared_ptr<Stream<T>> Stream<T>::Create(napi_env env, const StreamOptions &options) {
+    auto stream = std::make_shared<Stream>(Private{}, env, options);
+    napi_value resourceName;
+    NAPI_CHECK_STATUS(env, napi_create_string_utf8(env, "napi_stream", NAPI_AUTO_LENGTH, &resourceName),
+                      "napi_create_string_utf8 failed");
+    // tsfn持有Stream的一份引用，tsfn结束时释放
+    auto *box = new details::StreamBox<T>{stream};
+    napi_status status = napi_create_threadsafe_function(
+        env, nullptr, nullptr, resourceName, 0, 1, box,
+        [](napi_env, void *data, void *) { delete static_cast<details::StreamBox<T> *>(data); }, stream.get(),
+        [](napi_env env, napi_value, void *context, void *) {
+            if (env == nullptr) {
+                return;
+            }
+            // 异常不能穿过引擎的回调
+            try {
+                static_cast<Stream *>(context)->drain(env);
+            } catch (const std::exception &e) {
+                napi_throw_error(env, nullptr, e.what());
+            } catch (...) {
+                napi_throw_error(env, nullptr, "unknown native exception");
+            }
+        },
+        &stream->tsfn_);
+    if (status != napi_ok) {
+        delete box;
+        NAPI_CHECK_STATUS(env, status, "napi_create_threadsafe_function failed");
+    }
+    // 没有等待中的读取时不阻止事件循环退出
+    napi_unref_threadsafe_function(env, stream->tsfn_);
+    stream->loopRefed_ = false;
+    return stream;
+}
+
+template <typename T>
+inline Stream<T>::Stream(Private, napi_env env, const StreamOptions &options) : env_(env), options_(options) {
+    options_.highWaterMark = std::max<std::size_t>(options_.highWaterMark, 1);
+    options_.chunkSize = std::max<std::size_t>(options_.chunkSize, 1);
+}
+
+template <typename T> inline Object Stream<T>::reader() {
+    if (hasReader_) {
+        throw std::logic_error("Stream reader already created");
+    }
+    Object obj = Object::Create(env_);
+    napi_value asyncIterator;
+    Object symbol = Env(env_).global().as<Object>().get("Symbol").as<Object>();
+    NAPI_CHECK_STATUS(env_, napi_get_named_property(env_, symbol, "asyncIterator", &asyncIterator),
+                      "napi_get_named_property failed");
+    napi_property_descriptor desc[] = {
+        {"next", nullptr, Next, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"return", nullptr, Return, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {nullptr, asyncIterator, AsyncIterator, nullptr, nullptr, nullptr, napi_default, nullptr},
+    };
+    NAPI_CHECK_STATUS(env_, napi_define_properties(env_, obj, sizeof(desc) / sizeof(desc[0]), desc),
+                      "napi_define_properties failed");
+    // reader持有Stream的一份引用，reader被回收时取消流
+    auto *box = new details::StreamBox<T>{this->shared_from_this()};
+    napi_status status = napi_wrap(
+        env_, obj, box,
+        [](napi_env, void *data, void *) {
+            auto *box = static_cast<details::StreamBox<T> *>(data);
+            box->stream->cancel();
+            delete box;
+        },
+        nullptr, nullptr);
+    if (status != napi_ok) {
+        delete box;
+        NAPI_CHECK_STATUS(env_, status, "napi_wrap failed");
+    }
+    // 其他模块或Object::wrap包装的对象同样能unwrap出指针，Unwrap据此区分
+    obj.brand<details::StreamBox<T>>();
+    hasReader_ = true;
+    return obj;
+}
+
+template <typename T> inline bool Stream<T>::push(const T &value) { return pushOne(value); }
+
+template <typename T> inline bool Stream<T>::push(T &&value) { return pushOne(std::move(value)); }
+
+template <typename T> template <typename U> inline bool Stream<T>::pushOne(U &&value) {
+    std::unique_lock<std::mutex> lck(mtx_);
+    if (buffer_.size() >= options_.highWaterMark && !closed_ && !cancelled_) {
+        switch (options_.policy) {
+        case Backpressure::Block:
+            space_.wait(lck, [this] { return buffer_.size() < options_.highWaterMark || closed_ || cancelled_; });
+            break;
+        case Backpressure::DropNewest:
+            ++dropped_;
+            return false;
+        case Backpressure::DropOldest:
+            buffer_.pop_front();
+            ++dropped_;
+            break;
+        }
+    }
+    if (closed_ || cancelled_) {
+        return false;
+    }
+    buffer_.push_back(std::forward<U>(value));
+    wakeLocked();
+    return true;
+}
+
+template <typename T> inline std::size_t Stream<T>::push(const T *values, std::size_t count) {
+    std::size_t written = 0;
+    std::unique_lock<std::mutex> lck(mtx_);
+    while (written < count && !closed_ && !cancelled_) {
+        std::size_t space = options_.highWaterMark - std::min(buffer_.size(), options_.highWaterMark);
+        if (space == 0) {
+            if (options_.policy == Backpressure::DropNewest) {
+                dropped_ += count - written;
+                break;
+            }
+            if (options_.policy == Backpressure::DropOldest) {
+                // 只保留最新的highWaterMark个元素
+                std::size_t rest = count - written;
+                std::size_t keep = std::min(rest, options_.highWaterMark);
+                std::size_t evict = std::min(buffer_.size(), keep);
+                buffer_.erase(buffer_.begin(), buffer_.begin() + evict);
+                dropped_ += evict + (rest - keep);
+                buffer_.insert(buffer_.end(), values + count - keep, values + count);
+                written = count;
+                break;
+            }
+            wakeLocked();
+            space_.wait(lck, [this] { return buffer_.size() < options_.highWaterMark || closed_ || cancelled_; });
+            continue;
+        }
+        std::size_t n = std::min(space, count - written);
+        buffer_.insert(buffer_.end(), values + written, values + written + n);
+        written += n;
+    }
+    wakeLocked();
+    return written;
+}
+
+template <typename T> inline void Stream<T>::close() {
+    std::lock_guard<std::mutex> lck(mtx_);
+    if (closed_) {
+        return;
+    }
+    closed_ = true;
+    space_.notify_all();
+    wakeLocked();
+    releaseIdleLocked();
+}
+
+template <typename T> inline void Stream<T>::fail(const std::string &message) {
+    std::lock_guard<std::mutex> lck(mtx_);
+    if (closed_) {
+        return;
+    }
+    closed_ = true;
+    failed_ = true;
+    error_ = message;
+    space_.notify_all();
+    wakeLocked();
+    releaseIdleLocked();
+}
+
+template <typename T> inline bool Stream<T>::cancelled() const {
+    std::lock_guard<std::mutex> lck(mtx_);
+    return cancelled_;
+}
+
+template <typename T> inline std::size_t Stream<T>::dropped() const {
+    std::lock_guard<std::mutex> lck(mtx_);
+    return dropped_;
+}
+
+template <typename T> inline void Stream<T>::wakeLocked() {
+    if (wakeQueued_ || released_ || reads_.empty() || (buffer_.empty() && !closed_)) {
+        return;
+    }
+    if (napi_call_threadsafe_function(tsfn_, nullptr, napi_tsfn_nonblocking) == napi_ok) {
+        wakeQueued_ = true;
+    }
+}
+
+template <typename T> inline void Stream<T>::releaseLocked() {
+    if (!released_) {
+        released_ = true;
+        napi_release_threadsafe_function(tsfn_, napi_tsfn_abort);
+    }
+}
+
+template <typename T> inline void Stream<T>::releaseIdleLocked() {
+    // 结束后不再有需要唤醒JS线程的事件，之后的读取在next()中直接完成；
+    // 有等待中的读取时已排队唤醒，由drain释放
+    if (reads_.empty()) {
+        releaseLocked();
+    }
+}
+
+template <typename T> inline void Stream<T>::cancel() {
+    std::lock_guard<std::mutex> lck(mtx_);
+    cancelled_ = true;
+    buffer_.clear();
+    space_.notify_all();
+    releaseLocked();
+}
+
+template <typename T> inline Object Stream<T>::result(napi_env env, napi_value value, bool done) {
+    Object obj = Object::Create(env);
+    obj.set("value", value != nullptr ? Value(env, value) : Env(env).undefined());
+    obj.set("done", Boolean::Create(env, done));
+    return obj;
+}
+
+template <typename T> inline Value Stream<T>::takeChunk(napi_env env, std::unique_lock<std::mutex> &lck) {
+    std::size_t n = std::min(buffer_.size(), options_.chunkSize);
+    auto first = buffer_.begin();
+    auto last = first + n;
+    if constexpr (details::HasTypedArray<T>::value) {
+        auto array = TypedArrayOf<T>::Create(env, n);
+        std::copy(first, last, array.data());
+        buffer_.erase(first, last);
+        space_.notify_all();
+        lck.unlock();
+        return Value(env, array);
+    } else {
+        std::vector<T> items(std::make_move_iterator(first), std::make_move_iterator(last));
+        buffer_.erase(first, last);
+        space_.notify_all();
+        lck.unlock();
+        Array array = Array::Create(env, n);
+        for (std::size_t i = 0; i < n; ++i) {
+            array.set(static_cast<std::uint32_t>(i), Value(env, Converter<T>::ToJS(env, items[i])));
+        }
+        return Value(env, array);
+    }
+}
+
+template <typename T>
+inline void Stream<T>::Reject(napi_env env, napi_deferred deferred, const std::string &message) {
+    napi_value text;
+    napi_value error;
+    napi_create_string_utf8(env, message.c_str(), message.size(), &text);
+    napi_create_error(env, nullptr, text, &error);
+    napi_reject_deferred(env, deferred, error);
+}
+
+// 在JS线程中依次满足等待中的读取
+template <typename T> inline void Stream<T>::drain(napi_env env) {
+    std::unique_lock<std::mutex> lck(mtx_);
+    wakeQueued_ = false;
+    while (!reads_.empty() && (!buffer_.empty() || closed_ || cancelled_)) {
+        napi_deferred deferred = reads_.front();
+        reads_.pop_front();
+        if (!buffer_.empty()) {
+            // 转换失败时以reject结束这次读取，不能让等待它的Promise永远悬置
+            bool failed = true;
+            std::string error;
+            try {
+                napi_value chunk = result(env, takeChunk(env, lck), false);
+                napi_resolve_deferred(env, deferred, chunk);
+                failed = false;
+            } catch (const std::exception &e) {
+                error = e.what();
+            } catch (...) {
+                error = "unknown native exception";
+            }
+            if (failed) {
+                bool pendingException = false;
+                napi_is_exception_pending(env, &pendingException);
+                if (pendingException) {
+                    napi_value exception;
+                    napi_get_and_clear_last_exception(env, &exception);
+                    napi_reject_deferred(env, deferred, exception);
+                } else {
+                    Reject(env, deferred, error);
+                }
+            }
+            if (!lck.owns_lock()) {
+                lck.lock();
+            }
+        } else if (failed_ && !cancelled_) {
+            failed_ = false;
+            Reject(env, deferred, error_);
+        } else {
+            napi_resolve_deferred(env, deferred, result(env, nullptr, true));
+        }
+    }
+    if ((closed_ || cancelled_) && buffer_.empty()) {
+        if (!failed_) {
+            releaseLocked();
+        }
+    } else if (!released_ && loopRefed_ != !reads_.empty()) {
+        // 有等待中的读取时保持事件循环存活
+        loopRefed_ = !reads_.empty();
+        if (loopRefed_) {
+            napi_ref_threadsafe_function(env, tsfn_);
+        } else {
+            napi_unref_threadsafe_function(env, tsfn_);
+        }
+    }
+}
+
+template <typename T>
+inline Stream<T> *Stream<T>::Unwrap(napi_env env, napi_callback_info info, napi_value *self) {
+    napi_value thisArg;
+    NAPI_CHECK_STATUS(env, napi_get_cb_info(env, info, nullptr, nullptr, &thisArg, nullptr),
+                      "napi_get_cb_info failed");
+    void *data = nullptr;
+    if (!Object(env, thisArg).isBranded<details::StreamBox<T>>() || napi_unwrap(env, thisArg, &data) != napi_ok ||
+        data == nullptr) {
+        napi_throw_type_error(env, nullptr, "Illegal invocation");
+        return nullptr;
+    }
+    if (self != nullptr) {
+        *self = thisArg;
+    }
+    return static_cast<details::StreamBox<T> *>(data)->stream.get();
+}
+
+template <typename T> inline napi_value Stream<T>::Next(napi_env env, napi_callback_info info) {
+    details::HotValueScope hotValueScope;
+    try {
+        Stream *stream = Unwrap(env, info);
+        if (stream == nullptr) {
+            return nullptr;
+        }
+        napi_deferred deferred;
+        napi_value promise;
+        NAPI_CHECK_STATUS(env, napi_create_promise(env, &deferred, &promise), "napi_create_promise failed");
+        {
+            std::lock_guard<std::mutex> lck(stream->mtx_);
+            stream->reads_.push_back(deferred);
+        }
+        stream->drain(env);
+        return promise;
+    } catch (const std::exception &e) {
+        napi_throw_error(env, nullptr, e.what());
+    } catch (...) {
+        napi_throw_error(env, nullptr, "unknown native exception");
+    }
+    return nullptr;
+}
+
+template <typename T> inline napi_value Stream<T>::Return(napi_env env, napi_callback_info info) {
+    details::HotValueScope hotValueScope;
+    try {
+        Stream *stream = Unwrap(env, info);
+        if (stream == nullptr) {
+            return nullptr;
+        }
+        stream->cancel();
+        stream->drain(env);
+        napi_deferred deferred;
+        napi_value promise;
+        NAPI_CHECK_STATUS(env, napi_create_promise(env, &deferred, &promise), "napi_create_promise failed");
+        napi_resolve_deferred(env, deferred, stream->result(env, nullptr, true));
+        return promise;
+    } catch (const std::exception &e) {
+        napi_throw_error(env, nullptr, e.what());
+    } catch (...) {
+        napi_throw_error(env, nullptr, "unknown native exception");
+    }
+    return nullptr;
+}
+
+template <typename T> inline napi_value Stream<T>::AsyncIterator(napi_env env, napi_callback_info info) {
+    napi_value self = nullptr;
+    try {
+        Unwrap(env, info, &self);
+        return self;
+    } catch (const std::exception &e) {
+        napi_throw_error(env, nullptr, e.what());
+    } catch (...) {
+        napi_throw_error(env, nullptr, "unknown native exception");
+    }
+    return nullptr;
+}
+
+} // namespace napi
+} // namespace OHOS
+
+#endif // OHOS_NAPI_STREAM_H
@@ -0,0 +1,332 @@
+#ifndef OHOS_NAPI_TASK_H
+#define OHOS_NAPI_TASK_H
+
+#include "napi_framework.h"
+
+#include <deque>
+
+namespace OHOS {
+namespace napi {
+namespace tools {
+
+enum class TaskPriority { Immediate, High, Low, Idle };
+
+/**
+ * TaskPoster 从任意线程把Native闭包投递到JS线程执行
+ * - 非PORTABLE模式：每个任务通过napi_send_event按对应的优先级投递
+ * - PORTABLE模式：每个env一个threadsafe function作为唤醒句柄，任务按优先级排队，
+ *   一次唤醒内按优先级依次执行；Idle任务只在本次唤醒没有执行其他任务时执行，否则顺延到下一次唤醒。
+ *   句柄不阻止事件循环退出。
+ * 以相同的key投递的任务在执行前合并为一个，执行的是最后一次投递的闭包，
+ * 适合"状态已变化"一类的通知：一连串通知只触发一次JS侧刷新。
+ * 任务在独立的handle scope中执行，抛出的C++异常转换为JS异常。
+ */
+class TaskPoster : public std::enable_shared_from_this<TaskPoster> {
+    struct Private {};
+
+public:
+    using Task = std::function<void(napi_env)>;
+
+    /// env的投递器，首次调用时创建，须在JS线程上调用；返回的指针可以交给任意线程持有
+    static std::shared_ptr<TaskPoster> Get(napi_env env);
+
+    /// 投递task，任意线程可调用。env已销毁时返回false
+    bool post(Task task, TaskPriority priority = TaskPriority::High);
+    /// 同上，key相同且尚未执行的任务合并为一个：保留最后一次投递的task，优先级沿用合并中首次投递时的
+    bool post(std::string_view key, Task task, TaskPriority priority = TaskPriority::High);
+
+    /// 已投递尚未执行的任务数，合并的任务计为一个
+    std::size_t pending() const;
+    bool closed() const;
+
+    TaskPoster(Private, napi_env env) : env_(env) {}
+
+private:
+    struct Item {
+        Task task;
+        std::string key; // 非空时task存放在keyed_中
+    };
+    // EnvLocal中持有本env的投递器，env清理时关闭
+    struct Holder {
+        std::shared_ptr<TaskPoster> poster;
+        ~Holder();
+    };
+
+    bool enqueue(Task task, std::string key, TaskPriority priority);
+    // 在JS线程上执行一个任务
+    static void Run(napi_env env, Task &task);
+    // 取出key对应的闭包并执行
+    void runKeyed(napi_env env, const std::string &key);
+    void close();
+#ifdef NAPI_FRAMEWORK_PORTABLE
+    static constexpr std::size_t kLevels = 4;
+    // 须持有mtx_
+    bool wakeLocked();
+    void drain(napi_env env);
+
+    napi_threadsafe_function tsfn_ = nullptr;
+    std::deque<Item> queues_[kLevels];
+    bool wakeQueued_ = false;
+#endif
+
+    napi_env env_;
+    mutable std::mutex mtx_;
+    std::unordered_map<std::string, Task> keyed_;
+    std::size_t pending_ = 0;
+    bool closed_ = false;
+};
+
+/* --------------------------------- details -------------------------------- */
+
+namespace details {
+struct TaskPosterBox {
+    std::shared_ptr<TaskPoster> poster;
+};
+
+#ifndef NAPI_FRAMEWORK_PORTABLE
+inline napi_event_priority ToEventPriority(TaskPriority priority) {
+    switch (priority) {
+    case TaskPriority::Immediate:
+        return napi_eprio_immediate;
+    case TaskPriority::High:
+        return napi_eprio_high;
+    case TaskPriority::Low:
+        return napi_eprio_low;
+    default:
+        return napi_eprio_idle;
+    }
+}
+#endif
+} // namespace details
+
+inline std::shared_ptr<TaskPoster> TaskPoster::Get(napi_env env) {
+    Holder &holder = napi::details::EnvLocal<Holder>::Get(env);
+    if (holder.poster != nullptr) {
+        return holder.poster;
+    }
+    auto poster = std::make_shared<TaskPoster>(Private{}, env);
+#ifdef NAPI_FRAMEWORK_PORTABLE
+    napi_value resourceName;
+    NAPI_CHECK_STATUS(env, napi_create_string_utf8(env, "napi_task_poster", NAPI_AUTO_LENGTH, &resourceName),
+                      "napi_create_string_utf8 failed");
+    // tsfn持有投递器的一份引用，tsfn结束时释放
+    auto *box = new details::TaskPosterBox{poster};
+    napi_status status = napi_create_threadsafe_function(
+        env, nullptr, nullptr, resourceName, 0, 1, box,
+        [](napi_env, void *data, void *) {
+            auto *box = static_cast<details::TaskPosterBox *>(data);
+            {
+                std::lock_guard<std::mutex> lck(box->poster->mtx_);
+                box->poster->tsfn_ = nullptr;
+                box->poster->closed_ = true;
+            }
+            delete box;
+        },
+        poster.get(),
+        [](napi_env env, napi_value, void *context, void *) {
+            if (env != nullptr) {
+                static_cast<TaskPoster *>(context)->drain(env);
+            }
+        },
+        &poster->tsfn_);
+    if (status != napi_ok) {
+        delete box;
+        NAPI_CHECK_STATUS(env, status, "napi_create_threadsafe_function failed");
+    }
+    napi_unref_threadsafe_function(env, poster->tsfn_);
+#endif
+    holder.poster = poster;
+    return poster;
+}
+
+inline bool TaskPoster::post(Task task, TaskPriority priority) { return enqueue(std::move(task), {}, priority); }
+
+inline bool TaskPoster::post(std::string_view key, Task task, TaskPriority priority) {
+    if (key.empty()) {
+        throw std::invalid_argument("Coalescing key must not be empty");
+    }
+    return enqueue(std::move(task), std::string(key), priority);
+}
+
+inline std::size_t TaskPoster::pending() const {
+    std::lock_guard<std::mutex> lck(mtx_);
+    return pending_;
+}
+
+inline bool TaskPoster::closed() const {
+    std::lock_guard<std::mutex> lck(mtx_);
+    return closed_;
+}
+
+inline bool TaskPoster::enqueue(Task task, std::string key, TaskPriority priority) {
+    std::unique_lock<std::mutex> lck(mtx_);
+    if (closed_) {
+        return false;
+    }
+    if (!key.empty()) {
+        auto [it, inserted] = keyed_.try_emplace(key);
+        it->second = std::move(task);
+        if (!inserted) {
+            return true; // 合并到尚未执行的同key任务
+        }
+    }
+    ++pending_;
+#ifndef NAPI_FRAMEWORK_PORTABLE
+    lck.unlock();
+    // 事件持有投递器的一份引用，直到它执行或被丢弃
+    std::function<void()> event;
+    if (key.empty()) {
+        event = [self = shared_from_this(), task = std::move(task)]() mutable {
+            {
+                std::lock_guard<std::mutex> lck(self->mtx_);
+                --self->pending_;
+            }
+            Run(self->env_, task);
+        };
+    } else {
+        event = [self = shared_from_this(), key] { self->runKeyed(self->env_, key); };
+    }
+    napi_status status = napi_send_event(env_, event, details::ToEventPriority(priority));
+    if (status != napi_ok) {
+        lck.lock();
+        --pending_;
+        if (!key.empty()) {
+            keyed_.erase(key);
+        }
+        return false;
+    }
+    return true;
+#else
+    queues_[static_cast<std::size_t>(priority)].push_back(Item{std::move(task), std::move(key)});
+    if (!wakeLocked()) {
+        Item item = std::move(queues_[static_cast<std::size_t>(priority)].back());
+        queues_[static_cast<std::size_t>(priority)].pop_back();
+        --pending_;
+        if (!item.key.empty()) {
+            keyed_.erase(item.key);
+        }
+        return false;
+    }
+    return true;
+#endif
+}
+
+inline void TaskPoster::Run(napi_env env, Task &task) {
+    HandleScope scope(env);
+    const char *message = nullptr;
+    std::string what;
+    try {
+        task(env);
+        return;
+    } catch (const std::exception &e) {
+        what = e.what();
+        message = what.c_str();
+    } catch (...) {
+        message = "unknown native exception";
+    }
+    // 已有待处理的JS异常（如任务中调用JS抛出后又抛出了C++异常）时保留它，napi_throw_error此时不会生效
+    bool pendingException = false;
+    napi_is_exception_pending(env, &pendingException);
+    if (!pendingException) {
+        napi_throw_error(env, nullptr, message);
+    }
+}
+
+inline void TaskPoster::runKeyed(napi_env env, const std::string &key) {
+    Task task;
+    {
+        std::lock_guard<std::mutex> lck(mtx_);
+        auto it = keyed_.find(key);
+        if (it == keyed_.end()) {
+            return;
+        }
+        task = std::move(it->second);
+        keyed_.erase(it);
+        --pending_;
+    }
+    Run(env, task);
+}
+
+inline void TaskPoster::close() {
+    std::lock_guard<std::mutex> lck(mtx_);
+    closed_ = true;
+#ifdef NAPI_FRAMEWORK_PORTABLE
+    if (tsfn_ != nullptr) {
+        napi_release_threadsafe_function(tsfn_, napi_tsfn_abort);
+        tsfn_ = nullptr;
+    }
+#endif
+}
+
+inline TaskPoster::Holder::~Holder() {
+    if (poster != nullptr) {
+        poster->close();
+    }
+}
+
+#ifdef NAPI_FRAMEWORK_PORTABLE
+inline bool TaskPoster::wakeLocked() {
+    if (wakeQueued_) {
+        return true;
+    }
+    if (tsfn_ == nullptr || napi_call_threadsafe_function(tsfn_, nullptr, napi_tsfn_nonblocking) != napi_ok) {
+        return false;
+    }
+    wakeQueued_ = true;
+    return true;
+}
+
+inline void TaskPoster::drain(napi_env env) {
+    std::size_t budget;
+    {
+        std::lock_guard<std::mutex> lck(mtx_);
+        wakeQueued_ = false;
+        // 只执行本次唤醒时已在队列中的任务，执行期间新投递的任务由下一次唤醒处理，避免长时间占用JS线程
+        budget = pending_;
+    }
+    bool ranOther = false;
+    while (budget-- > 0) {
+        Item item;
+        {
+            std::lock_guard<std::mutex> lck(mtx_);
+            std::size_t level = 0;
+            while (level < kLevels && queues_[level].empty()) {
+                ++level;
+            }
+            if (level == kLevels) {
+                break;
+            }
+            if (level == static_cast<std::size_t>(TaskPriority::Idle) && ranOther) {
+                break; // 本次唤醒已执行过其他任务，Idle任务顺延到下一次唤醒
+            }
+            item = std::move(queues_[level].front());
+            queues_[level].pop_front();
+            if (!item.key.empty()) {
+                auto it = keyed_.find(item.key);
+                item.task = std::move(it->second);
+                keyed_.erase(it);
+            }
+            --pending_;
+            ranOther = ranOther || level != static_cast<std::size_t>(TaskPriority::Idle);
+        }
+        Run(env, item.task);
+        // 任务留下了JS异常时，此后的NAPI调用都会返回napi_pending_exception：先结束本次唤醒，
+        // 由Node把异常作为未捕获异常报告，其余任务在下一次唤醒中执行
+        bool pendingException = false;
+        napi_is_exception_pending(env, &pendingException);
+        if (pendingException) {
+            break;
+        }
+    }
+    std::lock_guard<std::mutex> lck(mtx_);
+    if (pending_ != 0) {
+        wakeLocked();
+    }
+}
+#endif
+
+} // namespace tools
+} // namespace napi
+} // namespace OHOS
+
+#endif // OHOS_NAPI_TASK_H